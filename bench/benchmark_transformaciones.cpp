@@ -0,0 +1,278 @@
+// Banco de pruebas de los kernels de transformacion.
+// Mide rotarImagen, escalarImagen y bilinearInterpolation sobre una grilla de
+// tamanos, canales, angulos, factores y estrategias de memoria, con calentamiento y repeticiones, y
+// escribe los resultados en JSON o CSV para poder comparar entre versiones.
+#include "procesamiento_imagen.h"
+#include "buddy_system.h"
+#include "asignadores.h"
+#include "planificador.h"
+#include "calidad_imagen.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Configuracion {
+    int calentamiento = 2;
+    int repeticiones = 15;
+    bool rapido = false;
+    bool csv = false;
+    std::string archivoSalida;
+    int hilos = 0;
+};
+
+struct Resultado {
+    std::string kernel;
+    std::string asignador;
+    int width, height, channels;
+    double parametro;
+    int anchoSalida, altoSalida;
+    int repeticiones;
+    double medianaMs, p95Ms, minMs, mediaMs;
+    double mpixPorSegundo, gbPorSegundo;
+};
+
+// Suma que se imprime al final para que el compilador no descarte los resultados
+uint64_t sumaControl = 0;
+
+template <typename F>
+std::vector<double> medir(const Configuracion& cfg, F&& ejecutar) {
+    for (int i = 0; i < cfg.calentamiento; ++i) ejecutar();
+    std::vector<double> tiempos;
+    tiempos.reserve(cfg.repeticiones);
+    for (int i = 0; i < cfg.repeticiones; ++i) {
+        auto inicio = std::chrono::steady_clock::now();
+        ejecutar();
+        auto fin = std::chrono::steady_clock::now();
+        tiempos.push_back(std::chrono::duration<double, std::milli>(fin - inicio).count());
+    }
+    return tiempos;
+}
+
+double percentil(std::vector<double> valores, double p) {
+    std::sort(valores.begin(), valores.end());
+    size_t i = static_cast<size_t>(p * (valores.size() - 1) + 0.5);
+    return valores[std::min(i, valores.size() - 1)];
+}
+
+Resultado resumir(const std::string& kernel, const std::string& asignador, int w, int h, int ch, double parametro,
+                  int wSalida, int hSalida, const std::vector<double>& tiempos, double pixeles, double bytes) {
+    Resultado r;
+    r.kernel = kernel;
+    r.asignador = asignador;
+    r.width = w;
+    r.height = h;
+    r.channels = ch;
+    r.parametro = parametro;
+    r.anchoSalida = wSalida;
+    r.altoSalida = hSalida;
+    r.repeticiones = static_cast<int>(tiempos.size());
+    r.medianaMs = percentil(tiempos, 0.5);
+    r.p95Ms = percentil(tiempos, 0.95);
+    r.minMs = *std::min_element(tiempos.begin(), tiempos.end());
+    double suma = 0;
+    for (double t : tiempos) suma += t;
+    r.mediaMs = suma / tiempos.size();
+    r.mpixPorSegundo = pixeles / (r.medianaMs * 1e3);
+    r.gbPorSegundo = bytes / (r.medianaMs * 1e6);
+    return r;
+}
+
+const char* const ASIGNADORES[] = {"heap", "buddy", "arena", "pool", "compartido", "externo"};
+
+// Rotacion o escalado completo con la estrategia de memoria indicada; buddy,
+// arena y externo se dimensionan para la salida de este caso
+Resultado medirTransformacion(const Configuracion& cfg, bool rotar, const std::string& tipoAsignador,
+                              const std::vector<unsigned char>& entrada, int w, int h, int ch, float parametro) {
+    int wSalida = 0, hSalida = 0;
+    if (rotar) {
+        calcularNuevoTamano(w, h, parametro, wSalida, hSalida);
+    } else {
+        wSalida = static_cast<int>(std::round(w * parametro));
+        hSalida = static_cast<int>(std::round(h * parametro));
+    }
+    size_t bytesSalida = static_cast<size_t>(wSalida) * hSalida * ch;
+
+    size_t memoriaBuddy = 1;
+    while (memoriaBuddy < bytesSalida * 2) memoriaBuddy <<= 1;
+    std::unique_ptr<BuddySystem> buddy;
+    std::vector<unsigned char> bufferExterno;
+    std::unique_ptr<AsignadorImagen> propio;
+    AsignadorImagen* asignador;
+    if (tipoAsignador == "buddy") {
+        buddy.reset(new BuddySystem(memoriaBuddy, false));
+        propio.reset(new AsignadorBuddy(*buddy));
+        asignador = propio.get();
+    } else if (tipoAsignador == "arena") {
+        propio.reset(new AsignadorArena(bytesSalida));
+        asignador = propio.get();
+    } else if (tipoAsignador == "pool") {
+        asignador = &AsignadorPoolHilo::delHilo();
+    } else if (tipoAsignador == "compartido") {
+        propio.reset(new PoolBuffers(bytesSalida * 2, std::chrono::milliseconds(2000)));
+        asignador = propio.get();
+    } else if (tipoAsignador == "externo") {
+        bufferExterno.resize(bytesSalida);
+        propio.reset(new AsignadorExterno(bufferExterno.data(), bufferExterno.size()));
+        asignador = propio.get();
+    } else {
+        propio.reset(new AsignadorHeap());
+        asignador = propio.get();
+    }
+
+    unsigned char* origen = const_cast<unsigned char*>(entrada.data());
+    std::vector<double> tiempos = medir(cfg, [&]() {
+        unsigned char* salida = rotar ? rotarImagen(origen, w, h, ch, parametro, *asignador, wSalida, hSalida)
+                                      : escalarImagen(origen, w, h, ch, parametro, *asignador, wSalida, hSalida);
+        if (!salida) throw std::runtime_error("El kernel no devolvio una imagen");
+        sumaControl += salida[(static_cast<size_t>(hSalida / 2) * wSalida + wSalida / 2) * ch];
+        asignador->liberar(salida);
+    });
+
+    double pixelesSalida = static_cast<double>(wSalida) * hSalida;
+    double bytes = static_cast<double>(w) * h * ch + pixelesSalida * ch;
+    return resumir(rotar ? "rotarImagen" : "escalarImagen", tipoAsignador, w, h, ch, parametro,
+                   wSalida, hSalida, tiempos, pixelesSalida, bytes);
+}
+
+// Muestreo suelto: puntos pseudoaleatorios, un canal por llamada
+Resultado medirBilineal(const Configuracion& cfg, const std::vector<unsigned char>& entrada, int w, int h, int ch) {
+    const int muestras = 1 << 20;
+    std::vector<float> xs(muestras), ys(muestras);
+    std::mt19937 generador(777);
+    std::uniform_real_distribution<float> dx(0.0f, w - 1.0f), dy(0.0f, h - 1.0f);
+    for (int i = 0; i < muestras; ++i) {
+        xs[i] = dx(generador);
+        ys[i] = dy(generador);
+    }
+
+    unsigned char* origen = const_cast<unsigned char*>(entrada.data());
+    std::vector<double> tiempos = medir(cfg, [&]() {
+        unsigned suma = 0;
+        for (int i = 0; i < muestras; ++i) {
+            suma += bilinearInterpolation(xs[i], ys[i], origen, w, h, ch, i % ch);
+        }
+        sumaControl += suma;
+    });
+    // Cada muestra lee 4 vecinos de un byte
+    return resumir("bilinearInterpolation", "-", w, h, ch, 0.0, 0, 0, tiempos, muestras, muestras * 4.0);
+}
+
+void escribirCSV(std::ostream& os, const std::vector<Resultado>& resultados) {
+    os << "kernel,asignador,ancho,alto,canales,parametro,ancho_salida,alto_salida,repeticiones,"
+          "mediana_ms,p95_ms,min_ms,media_ms,mpix_s,gb_s\n";
+    for (const Resultado& r : resultados) {
+        os << r.kernel << ',' << r.asignador << ',' << r.width << ',' << r.height << ',' << r.channels << ','
+           << r.parametro << ',' << r.anchoSalida << ',' << r.altoSalida << ',' << r.repeticiones << ','
+           << r.medianaMs << ',' << r.p95Ms << ',' << r.minMs << ',' << r.mediaMs << ','
+           << r.mpixPorSegundo << ',' << r.gbPorSegundo << '\n';
+    }
+}
+
+void escribirJSON(std::ostream& os, const std::vector<Resultado>& resultados, const Configuracion& cfg) {
+    os << "{\n  \"hilos\": " << Planificador::global().numHilos()
+       << ",\n  \"calentamiento\": " << cfg.calentamiento
+       << ",\n  \"repeticiones\": " << cfg.repeticiones
+       << ",\n  \"resultados\": [\n";
+    for (size_t i = 0; i < resultados.size(); ++i) {
+        const Resultado& r = resultados[i];
+        os << "    {\"kernel\": \"" << r.kernel << "\", \"asignador\": \"" << r.asignador
+           << "\", \"ancho\": " << r.width << ", \"alto\": " << r.height << ", \"canales\": " << r.channels
+           << ", \"parametro\": " << r.parametro << ", \"ancho_salida\": " << r.anchoSalida
+           << ", \"alto_salida\": " << r.altoSalida << ", \"mediana_ms\": " << r.medianaMs
+           << ", \"p95_ms\": " << r.p95Ms << ", \"min_ms\": " << r.minMs << ", \"media_ms\": " << r.mediaMs
+           << ", \"mpix_s\": " << r.mpixPorSegundo << ", \"gb_s\": " << r.gbPorSegundo << "}"
+           << (i + 1 < resultados.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+void mostrarAyuda() {
+    std::cout << "Uso: ./build/benchmark_transformaciones [-formato json|csv] [-salida archivo] [-repeticiones N]\n";
+    std::cout << "       [-calentamiento N] [-hilos N] [-rapido]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Configuracion cfg;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-formato" && i + 1 < argc) {
+                std::string formato = argv[++i];
+                if (formato != "json" && formato != "csv") throw std::runtime_error("Formato desconocido: " + formato);
+                cfg.csv = formato == "csv";
+            } else if (arg == "-salida" && i + 1 < argc) {
+                cfg.archivoSalida = argv[++i];
+            } else if (arg == "-repeticiones" && i + 1 < argc) {
+                cfg.repeticiones = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "-calentamiento" && i + 1 < argc) {
+                cfg.calentamiento = std::max(0, std::stoi(argv[++i]));
+            } else if (arg == "-hilos" && i + 1 < argc) {
+                cfg.hilos = std::stoi(argv[++i]);
+            } else if (arg == "-rapido") {
+                cfg.rapido = true;
+            } else {
+                mostrarAyuda();
+                return 1;
+            }
+        }
+        Planificador::configurar(cfg.hilos, false);
+
+        std::vector<std::pair<int, int>> tamanos = {{256, 256}, {1024, 768}, {1920, 1080}};
+        if (!cfg.rapido) tamanos.push_back({4096, 3072});
+        const int canales[] = {1, 3, 4};
+        const float angulos[] = {15.0f, 45.0f, 90.0f};
+        const float factores[] = {0.5f, 1.5f, 2.0f};
+
+        std::vector<Resultado> resultados;
+        for (const auto& tamano : tamanos) {
+            for (int ch : canales) {
+                int w = tamano.first, h = tamano.second;
+                // Ruido: evita imagenes uniformes que favorezcan a la cache
+                std::vector<unsigned char> entrada = generarImagenSintetica(PatronSintetico::Ruido, w, h, ch);
+                std::cerr << "[BENCH] " << w << "x" << h << "x" << ch << "\n";
+
+                for (const char* asignador : ASIGNADORES) {
+                    for (float angulo : angulos) {
+                        resultados.push_back(medirTransformacion(cfg, true, asignador, entrada, w, h, ch, angulo));
+                    }
+                    for (float factor : factores) {
+                        resultados.push_back(medirTransformacion(cfg, false, asignador, entrada, w, h, ch, factor));
+                    }
+                }
+                resultados.push_back(medirBilineal(cfg, entrada, w, h, ch));
+            }
+        }
+
+        std::ostringstream texto;
+        if (cfg.csv) escribirCSV(texto, resultados);
+        else escribirJSON(texto, resultados, cfg);
+
+        if (cfg.archivoSalida.empty()) {
+            std::cout << texto.str();
+        } else {
+            std::ofstream archivo(cfg.archivoSalida);
+            if (!(archivo << texto.str())) throw std::runtime_error("No se pudo escribir " + cfg.archivoSalida);
+            std::cerr << "[BENCH] Resultados guardados en " << cfg.archivoSalida << "\n";
+        }
+        std::cerr << "[BENCH] Suma de control: " << sumaControl << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
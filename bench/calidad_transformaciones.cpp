@@ -0,0 +1,502 @@
+// Control de calidad de los kernels de transformacion.
+// Genera entradas sinteticas deterministas, ejecuta rotarImagen y
+// escalarImagen (con memoria dinamica y con Buddy System) y compara cada
+// salida con una referencia guardada (PSNR, SSIM y diferencia maxima).
+// Ademas, cada salida con Buddy System debe ser identica byte a byte a la
+// del mismo caso con memoria dinamica: el asignador no cambia el algoritmo,
+// asi que solo se guarda la referencia de memoria dinamica y ambos se miden contra ella.
+// Las verificaciones (filas "verificar_*") no usan referencia: comprueban una
+// propiedad que la salida debe cumplir, con la desviacion en la columna dif_max.
+//
+//   ./build/calidad_transformaciones -generar bench/referencias/   (version conocida)
+//   ./build/calidad_transformaciones -comparar bench/referencias/  (despues de un cambio)
+#include "procesamiento_imagen.h"
+#include "asignadores.h"
+#include "buddy_system.h"
+#include "calidad_imagen.h"
+#include "espacio_color.h"
+#include "planificador.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+struct Tolerancias {
+    double psnrMinimo = 40.0;
+    double ssimMinimo = 0.98;
+    int diferenciaMaxima = 8;
+};
+
+struct Caso {
+    PatronSintetico patron;
+    int channels;
+    bool rotar;
+    float parametro;
+    bool conBuddy;
+    FondoTransformacion fondo = FondoTransformacion();   // Solo rotaciones
+    Interpolacion interpolacion = Interpolacion::Bilineal;
+
+
+    // Nombre sin el asignador: los casos heap y buddy equivalentes lo comparten
+    std::string base() const {
+        std::ostringstream os;
+        os << nombrePatron(patron) << "_c" << channels << (rotar ? "_rotar" : "_escalar") << parametro;
+        switch (fondo.modo) {
+            case ModoFondo::Transparente: break;
+            case ModoFondo::Constante:
+                os << "_fondo" << int(fondo.color[0]) << '-' << int(fondo.color[1]) << '-' << int(fondo.color[2]) << '-'
+                   << int(fondo.color[3]);
+                break;
+            case ModoFondo::ExtenderBorde: os << "_extender"; break;
+            case ModoFondo::Repetir: os << "_repetir"; break;
+            case ModoFondo::Alfa: os << "_alfa"; break;
+        }
+        if (interpolacion == Interpolacion::BilinealLineal) os << "_lineal";
+        else if (interpolacion == Interpolacion::Vecino) os << "_vecino";
+        return os.str();
+    }
+    std::string nombre() const { return base() + (conBuddy ? "_buddy" : "_heap"); }
+    std::string referencia() const { return base() + "_heap"; }
+};
+
+struct Imagen {
+    std::vector<unsigned char> pixeles;
+    int width = 0, height = 0, channels = 0;
+};
+
+const int ANCHO_ENTRADA = 96;
+const int ALTO_ENTRADA = 80;
+
+Imagen ejecutarCaso(const Caso& caso) {
+    std::vector<unsigned char> entrada = generarImagenSintetica(caso.patron, ANCHO_ENTRADA, ALTO_ENTRADA, caso.channels);
+    Imagen salida;
+    salida.channels = caso.rotar ? canalesConFondo(caso.channels, caso.fondo) : caso.channels;
+
+    BuddySystem buddy(4 * 1024 * 1024, false);
+    AsignadorBuddy asignadorBuddy(buddy);
+    AsignadorHeap asignadorHeap;
+    AsignadorImagen& asignador = caso.conBuddy ? static_cast<AsignadorImagen&>(asignadorBuddy) : asignadorHeap;
+    unsigned char* resultado;
+    if (caso.rotar) {
+        resultado = rotarImagen(entrada.data(), ANCHO_ENTRADA, ALTO_ENTRADA, caso.channels, caso.parametro, asignador,
+                                salida.width, salida.height, caso.fondo, caso.interpolacion);
+    } else {
+        resultado = escalarImagen(entrada.data(), ANCHO_ENTRADA, ALTO_ENTRADA, caso.channels, caso.parametro, asignador,
+                                  salida.width, salida.height, caso.interpolacion);
+    }
+    if (!resultado) throw std::runtime_error("El kernel fallo en " + caso.nombre());
+
+    salida.pixeles.assign(resultado, resultado + static_cast<size_t>(salida.width) * salida.height * salida.channels);
+    asignador.liberar(resultado);
+    return salida;
+}
+
+// Las referencias se guardan en PAM (P7), que admite cualquier cantidad de canales
+bool guardarPAM(const std::string& ruta, const Imagen& img) {
+    FILE* archivo = fopen(ruta.c_str(), "wb");
+    if (!archivo) return false;
+    fprintf(archivo, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH %d\nMAXVAL 255\nENDHDR\n", img.width, img.height, img.channels);
+    bool ok = fwrite(img.pixeles.data(), 1, img.pixeles.size(), archivo) == img.pixeles.size();
+    return (fclose(archivo) == 0) && ok;
+}
+
+bool cargarPAM(const std::string& ruta, Imagen& img) {
+    FILE* archivo = fopen(ruta.c_str(), "rb");
+    if (!archivo) return false;
+    int maxval = 0;
+    bool ok = fscanf(archivo, "P7 WIDTH %d HEIGHT %d DEPTH %d MAXVAL %d ENDHDR", &img.width, &img.height,
+                     &img.channels, &maxval) == 4 && maxval == 255 && fgetc(archivo) == '\n';
+    if (ok) {
+        img.pixeles.resize(static_cast<size_t>(img.width) * img.height * img.channels);
+        ok = fread(img.pixeles.data(), 1, img.pixeles.size(), archivo) == img.pixeles.size();
+    }
+    fclose(archivo);
+    return ok;
+}
+
+std::vector<Caso> listarCasos() {
+    std::vector<Caso> casos;
+    const PatronSintetico patrones[] = {PatronSintetico::Degradado, PatronSintetico::Tablero,
+                                        PatronSintetico::Ruido, PatronSintetico::Zonas};
+    const int canales[] = {1, 3, 4};
+    const float angulos[] = {15.0f, 45.0f, 90.0f};
+    const float factores[] = {0.5f, 1.7f};
+    for (PatronSintetico patron : patrones) {
+        for (int ch : canales) {
+            for (int buddy = 0; buddy < 2; ++buddy) {
+                for (float a : angulos) casos.push_back({patron, ch, true, a, buddy == 1});
+                for (float f : factores) casos.push_back({patron, ch, false, f, buddy == 1});
+            }
+        }
+    }
+
+    // Modos de fondo: la parte de la salida que cae fuera de la fuente
+    FondoTransformacion extender, repetir, constante;
+    extender.modo = ModoFondo::ExtenderBorde;
+    repetir.modo = ModoFondo::Repetir;
+    constante.modo = ModoFondo::Constante;
+    const unsigned char color[4] = {200, 40, 90, 128};
+    std::memcpy(constante.color, color, sizeof(color));
+    for (PatronSintetico patron : {PatronSintetico::Degradado, PatronSintetico::Ruido}) {
+        for (int ch : canales) {
+            for (int buddy = 0; buddy < 2; ++buddy) {
+                for (const FondoTransformacion& fondo : {extender, repetir, constante}) {
+                    casos.push_back({patron, ch, true, 30.0f, buddy == 1, fondo});
+                }
+            }
+        }
+    }
+    // Salida con canal alfa: gris y RGB ganan un canal, RGBA mezcla el alfa de la fuente
+    FondoTransformacion alfa;
+    alfa.modo = ModoFondo::Alfa;
+    for (PatronSintetico patron : {PatronSintetico::Degradado, PatronSintetico::Zonas}) {
+        for (int ch : canales) {
+            for (int buddy = 0; buddy < 2; ++buddy) {
+                casos.push_back({patron, ch, true, 30.0f, buddy == 1, alfa});
+                casos.push_back({patron, ch, true, 89.5f, buddy == 1, alfa});
+            }
+        }
+    }
+    // Bilineal en luz lineal, incluida la mezcla premultiplicada de RGBA. La reduccion es
+    // 0.6 y no 0.5: con 0.5 cada muestra cae justo sobre un pixel de la fuente y no mezcla nada
+    for (PatronSintetico patron : {PatronSintetico::Degradado, PatronSintetico::Zonas}) {
+        for (int ch : canales) {
+            for (int buddy = 0; buddy < 2; ++buddy) {
+                casos.push_back({patron, ch, true, 30.0f, buddy == 1, FondoTransformacion(), Interpolacion::BilinealLineal});
+                casos.push_back({patron, ch, false, 0.6f, buddy == 1, FondoTransformacion(), Interpolacion::BilinealLineal});
+                casos.push_back({patron, ch, false, 1.7f, buddy == 1, FondoTransformacion(), Interpolacion::BilinealLineal});
+            }
+        }
+    }
+    // Angulos casi alineados con los ejes: cada fila tiene un tramo valido largo y
+    // bordes de un pixel de ancho, justo donde se recorta el tramo
+    for (int ch : {1, 4}) {
+        for (float a : {0.5f, 89.5f}) {
+            for (const FondoTransformacion& fondo : {FondoTransformacion(), constante}) {
+                casos.push_back({PatronSintetico::Tablero, ch, true, a, false, fondo});
+                casos.push_back({PatronSintetico::Tablero, ch, true, a, true, fondo});
+            }
+        }
+    }
+    return casos;
+}
+
+// ---- Verificaciones sin referencia ----
+
+struct Verificacion {
+    std::string nombre;
+    int width = 0, height = 0;
+    int diferenciaMaxima = 0;
+    bool ok = false;
+};
+
+// RGBA opaco de un solo color rodeado por un borde transparente de otro color:
+// con interpolacion premultiplicada el borde no debe teñir ningun pixel visible
+const int BORDE_TRANSPARENTE = 6;
+const unsigned char COLOR_INTERIOR[4] = {40, 160, 220, 255};
+const unsigned char COLOR_BORDE[4] = {255, 0, 0, 0};
+
+std::vector<unsigned char> imagenBordeTransparente() {
+    std::vector<unsigned char> img(static_cast<size_t>(ANCHO_ENTRADA) * ALTO_ENTRADA * 4);
+    for (int y = 0; y < ALTO_ENTRADA; ++y) {
+        for (int x = 0; x < ANCHO_ENTRADA; ++x) {
+            bool borde = x < BORDE_TRANSPARENTE || y < BORDE_TRANSPARENTE || x >= ANCHO_ENTRADA - BORDE_TRANSPARENTE ||
+                         y >= ALTO_ENTRADA - BORDE_TRANSPARENTE;
+            std::memcpy(&img[(static_cast<size_t>(y) * ANCHO_ENTRADA + x) * 4], borde ? COLOR_BORDE : COLOR_INTERIOR, 4);
+        }
+    }
+    return img;
+}
+
+// Mayor diferencia de color con COLOR_INTERIOR entre los pixeles con alfa > 0
+int desviacionColorVisible(const unsigned char* px, size_t pixeles) {
+    int maxima = 0;
+    for (size_t i = 0; i < pixeles; ++i, px += 4) {
+        if (px[3] == 0) continue;
+        for (int c = 0; c < 3; ++c) maxima = std::max(maxima, std::abs(px[c] - COLOR_INTERIOR[c]));
+    }
+    return maxima;
+}
+
+void verificarBordeTransparente(std::vector<Verificacion>& verificaciones) {
+    std::vector<unsigned char> entrada = imagenBordeTransparente();
+    AsignadorHeap asignador;
+
+    struct Transformacion { const char* nombre; bool rotar; float parametro; };
+    const Transformacion transformaciones[] = {{"rotar30", true, 30.0f}, {"rotar89.5", true, 89.5f},
+                                               {"escalar0.5", false, 0.5f}, {"escalar1.7", false, 1.7f}};
+    for (Interpolacion interpolacion : {Interpolacion::Bilineal, Interpolacion::BilinealLineal}) {
+        for (const Transformacion& t : transformaciones) {
+            Verificacion v;
+            v.nombre = std::string("verificar_borde_transparente_") + t.nombre +
+                       (interpolacion == Interpolacion::BilinealLineal ? "_lineal" : "");
+            unsigned char* salida = t.rotar
+                ? rotarImagen(entrada.data(), ANCHO_ENTRADA, ALTO_ENTRADA, 4, t.parametro, asignador, v.width, v.height,
+                              FondoTransformacion(), interpolacion)
+                : escalarImagen(entrada.data(), ANCHO_ENTRADA, ALTO_ENTRADA, 4, t.parametro, asignador, v.width, v.height,
+                                interpolacion);
+            if (!salida) throw std::runtime_error("El kernel fallo en " + v.nombre);
+            v.diferenciaMaxima = desviacionColorVisible(salida, static_cast<size_t>(v.width) * v.height);
+            asignador.liberar(salida);
+            v.ok = v.diferenciaMaxima <= 1;
+            verificaciones.push_back(v);
+        }
+    }
+
+    // bilinearInterpolation, muestreando en cuartos de pixel a traves del borde
+    Verificacion v;
+    v.nombre = "verificar_borde_transparente_bilinearInterpolation";
+    v.width = ANCHO_ENTRADA * 4;
+    v.height = ALTO_ENTRADA * 4;
+    std::vector<unsigned char> muestras(static_cast<size_t>(v.width) * v.height * 4);
+    for (int y = 0; y < v.height; ++y) {
+        for (int x = 0; x < v.width; ++x) {
+            for (int c = 0; c < 4; ++c) {
+                muestras[(static_cast<size_t>(y) * v.width + x) * 4 + c] =
+                    bilinearInterpolation(x * 0.25f, y * 0.25f, entrada.data(), ANCHO_ENTRADA, ALTO_ENTRADA, 4, c);
+            }
+        }
+    }
+    v.diferenciaMaxima = desviacionColorVisible(muestras.data(), static_cast<size_t>(v.width) * v.height);
+    v.ok = v.diferenciaMaxima <= 1;
+    verificaciones.push_back(v);
+}
+
+// Tablas de espacio_color: cada valor sRGB debe volver exactamente a si mismo, y
+// ningun valor lineal de 16 bits puede alejarse mas de 1 del redondeo exacto
+void verificarTablasColor(std::vector<Verificacion>& verificaciones) {
+    const TablasColor& tablas = tablasColor();
+
+    Verificacion idaVuelta;
+    idaVuelta.nombre = "verificar_srgb_ida_vuelta";
+    idaVuelta.width = 256;
+    idaVuelta.height = 1;
+    for (int v = 0; v < 256; ++v) {
+        int vuelta = tablas.srgbDesdeLineal(tablas.aLineal[v]);
+        idaVuelta.diferenciaMaxima = std::max(idaVuelta.diferenciaMaxima, std::abs(vuelta - v));
+    }
+    idaVuelta.ok = idaVuelta.diferenciaMaxima == 0;
+    verificaciones.push_back(idaVuelta);
+
+    Verificacion vuelta;
+    vuelta.nombre = "verificar_srgb_desde_lineal";
+    vuelta.width = 65536;
+    vuelta.height = 1;
+    for (int l = 0; l < 65536; ++l) {
+        int exacto = static_cast<int>(std::lround(linealASrgb(l / 65535.0f) * 255.0f));
+        vuelta.diferenciaMaxima = std::max(vuelta.diferenciaMaxima, std::abs(tablas.srgbDesdeLineal(l) - exacto));
+    }
+    vuelta.ok = vuelta.diferenciaMaxima <= 1;
+    verificaciones.push_back(vuelta);
+}
+
+// Muestras de 16 bits y float: la misma entrada llevada a 0..65535 o a 0..1 debe dar,
+// de vuelta en 8 bits, la salida del caso de 8 bits (que si tiene referencia) con
+// una diferencia de a lo sumo 1 por el redondeo. Ademas las salidas de 16 bits y
+// float deben coincidir entre si con precision de 16 bits: asi se detecta un camino
+// que pase por 8 bits sin decirlo. Las muestras float ya estan en luz lineal, asi
+// que en modo lineal el color se pasa por la curva sRGB a la ida y a la vuelta.
+struct SalidaNormalizada {
+    std::vector<float> valores;   // 0..1, color en sRGB
+    int width = 0, height = 0, channels = 0;
+};
+
+bool esAlfa(int canal, int channels) {
+    return (channels == 2 || channels == 4) && canal == channels - 1;
+}
+
+template <typename T>
+SalidaNormalizada ejecutarConMuestras(const Caso& caso) {
+    const float maximo = std::is_same<T, float>::value ? 1.0f : 65535.0f;
+    const bool curvaSrgb = std::is_same<T, float>::value && caso.interpolacion == Interpolacion::BilinealLineal;
+    std::vector<unsigned char> entrada8 = generarImagenSintetica(caso.patron, ANCHO_ENTRADA, ALTO_ENTRADA, caso.channels);
+    std::vector<T> entrada(entrada8.size());
+    for (size_t i = 0; i < entrada.size(); ++i) {
+        float v = entrada8[i] / 255.0f;
+        if (curvaSrgb && !esAlfa(static_cast<int>(i % caso.channels), caso.channels)) v = srgbALineal(v);
+        entrada[i] = static_cast<T>(v * maximo + (std::is_same<T, float>::value ? 0.0f : 0.5f));
+    }
+
+    SalidaNormalizada salida;
+    salida.channels = caso.rotar ? canalesConFondo(caso.channels, caso.fondo) : caso.channels;
+    AsignadorHeap asignador;
+    T* resultado = caso.rotar
+        ? rotarImagen(entrada.data(), ANCHO_ENTRADA, ALTO_ENTRADA, caso.channels, caso.parametro, asignador,
+                      salida.width, salida.height, caso.fondo, caso.interpolacion)
+        : escalarImagen(entrada.data(), ANCHO_ENTRADA, ALTO_ENTRADA, caso.channels, caso.parametro, asignador,
+                        salida.width, salida.height, caso.interpolacion);
+    if (!resultado) throw std::runtime_error("El kernel fallo en " + caso.nombre());
+
+    salida.valores.resize(static_cast<size_t>(salida.width) * salida.height * salida.channels);
+    for (size_t i = 0; i < salida.valores.size(); ++i) {
+        float v = resultado[i] / maximo;
+        if (curvaSrgb && !esAlfa(static_cast<int>(i % salida.channels), salida.channels)) v = linealASrgb(v);
+        salida.valores[i] = v;
+    }
+    asignador.liberar(reinterpret_cast<unsigned char*>(resultado));
+    return salida;
+}
+
+// Diferencia maxima entre 'a' y 'b' en unidades de 1/escala (255 u 65535)
+Verificacion compararNormalizadas(const std::string& nombre, const SalidaNormalizada& a, const SalidaNormalizada& b,
+                                  float escala) {
+    Verificacion v;
+    v.nombre = nombre;
+    v.width = a.width;
+    v.height = a.height;
+    if (a.width != b.width || a.height != b.height || a.channels != b.channels) {
+        v.diferenciaMaxima = static_cast<int>(escala);
+        return v;
+    }
+    for (size_t i = 0; i < a.valores.size(); ++i) {
+        auto cuantizar = [escala](float x) { return std::lround(std::min(std::max(x, 0.0f), 1.0f) * escala); };
+        v.diferenciaMaxima = std::max(v.diferenciaMaxima, static_cast<int>(std::abs(cuantizar(a.valores[i]) - cuantizar(b.valores[i]))));
+    }
+    v.ok = v.diferenciaMaxima <= 1;
+    return v;
+}
+
+void verificarMuestrasProfundas(std::vector<Verificacion>& verificaciones) {
+    FondoTransformacion alfa;
+    alfa.modo = ModoFondo::Alfa;
+    for (PatronSintetico patron : {PatronSintetico::Degradado, PatronSintetico::Zonas}) {
+        for (int ch : {1, 3, 4}) {
+            const Caso casos[] = {
+                {patron, ch, true, 45.0f, false},
+                {patron, ch, false, 1.7f, false},
+                {patron, ch, true, 30.0f, false, alfa},
+                {patron, ch, true, 30.0f, false, FondoTransformacion(), Interpolacion::BilinealLineal},
+                {patron, ch, false, 0.6f, false, FondoTransformacion(), Interpolacion::BilinealLineal},
+            };
+            for (const Caso& caso : casos) {
+                Imagen bits8 = ejecutarCaso(caso);
+                SalidaNormalizada esperada;
+                esperada.width = bits8.width;
+                esperada.height = bits8.height;
+                esperada.channels = bits8.channels;
+                for (unsigned char v : bits8.pixeles) esperada.valores.push_back(v / 255.0f);
+
+                SalidaNormalizada bits16 = ejecutarConMuestras<uint16_t>(caso);
+                SalidaNormalizada flotante = ejecutarConMuestras<float>(caso);
+                verificaciones.push_back(compararNormalizadas("verificar_16bits_" + caso.base(), bits16, esperada, 255.0f));
+                verificaciones.push_back(compararNormalizadas("verificar_float_" + caso.base(), flotante, esperada, 255.0f));
+                verificaciones.push_back(compararNormalizadas("verificar_16bits_float_" + caso.base(), bits16, flotante, 65535.0f));
+            }
+        }
+    }
+}
+
+void mostrarAyuda() {
+    std::cout << "Uso: ./build/calidad_transformaciones -generar DIR | -comparar DIR\n";
+    std::cout << "       [-psnr-min dB] [-ssim-min valor] [-dif-max valor] [-hilos N]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string directorio;
+    bool generar = false;
+    Tolerancias tolerancias;
+    int hilos = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if ((arg == "-generar" || arg == "-comparar") && i + 1 < argc) {
+                generar = arg == "-generar";
+                directorio = argv[++i];
+            } else if (arg == "-psnr-min" && i + 1 < argc) {
+                tolerancias.psnrMinimo = std::stod(argv[++i]);
+            } else if (arg == "-ssim-min" && i + 1 < argc) {
+                tolerancias.ssimMinimo = std::stod(argv[++i]);
+            } else if (arg == "-dif-max" && i + 1 < argc) {
+                tolerancias.diferenciaMaxima = std::stoi(argv[++i]);
+            } else if (arg == "-hilos" && i + 1 < argc) {
+                hilos = std::stoi(argv[++i]);
+            } else {
+                mostrarAyuda();
+                return 1;
+            }
+        }
+        if (directorio.empty()) {
+            mostrarAyuda();
+            return 1;
+        }
+        Planificador::configurar(hilos, false);
+
+        std::vector<Caso> casos = listarCasos();
+        if (generar) {
+            mkdir(directorio.c_str(), 0755);
+            int guardadas = 0;
+            for (const Caso& caso : casos) {
+                if (caso.conBuddy) continue;
+                ++guardadas;
+                if (!guardarPAM(directorio + "/" + caso.nombre() + ".pam", ejecutarCaso(caso))) {
+                    throw std::runtime_error("No se pudo escribir la referencia " + caso.nombre());
+                }
+            }
+            std::cout << "[CALIDAD] " << guardadas << " referencias guardadas en " << directorio << "\n";
+            return 0;
+        }
+
+        int fallidos = 0;
+        std::map<std::string, Imagen> salidasHeap;
+        std::cout << "caso,ancho,alto,psnr_db,ssim,dif_max,resultado\n";
+        for (const Caso& caso : casos) {
+            Imagen referencia;
+            if (!cargarPAM(directorio + "/" + caso.referencia() + ".pam", referencia)) {
+                throw std::runtime_error("Falta la referencia " + caso.referencia() + " (usar -generar primero)");
+            }
+            Imagen actual = ejecutarCaso(caso);
+
+            bool mismoTamano = actual.width == referencia.width && actual.height == referencia.height &&
+                               actual.channels == referencia.channels;
+            MetricasCalidad m;
+            if (mismoTamano) {
+                m = compararImagenes(actual.pixeles.data(), referencia.pixeles.data(), actual.width, actual.height, actual.channels);
+            }
+            bool igualHeap = true;
+            if (caso.conBuddy) {
+                auto heap = salidasHeap.find(caso.base());
+                igualHeap = heap != salidasHeap.end() && heap->second.width == actual.width &&
+                            heap->second.height == actual.height && heap->second.pixeles == actual.pixeles;
+            } else {
+                salidasHeap[caso.base()] = actual;
+            }
+            bool ok = mismoTamano && igualHeap && m.psnr >= tolerancias.psnrMinimo && m.ssim >= tolerancias.ssimMinimo &&
+                      m.diferenciaMaxima <= tolerancias.diferenciaMaxima;
+            if (!ok) ++fallidos;
+
+            std::cout << caso.nombre() << ',' << actual.width << ',' << actual.height << ',';
+            if (mismoTamano) std::cout << m.psnr << ',' << m.ssim << ',' << m.diferenciaMaxima;
+            else std::cout << "-,-,-";
+            std::cout << ',' << (ok ? "ok" : (!mismoTamano ? "FALLA_TAMANO" : (!igualHeap ? "FALLA_BUDDY" : "FALLA"))) << '\n';
+        }
+
+        std::vector<Verificacion> verificaciones;
+        verificarBordeTransparente(verificaciones);
+        verificarTablasColor(verificaciones);
+        verificarMuestrasProfundas(verificaciones);
+        for (const Verificacion& v : verificaciones) {
+            if (!v.ok) ++fallidos;
+            std::cout << v.nombre << ',' << v.width << ',' << v.height << ",-,-," << v.diferenciaMaxima << ','
+                      << (v.ok ? "ok" : "FALLA") << '\n';
+        }
+        std::cerr << "[CALIDAD] Casos: " << casos.size() + verificaciones.size() << " | Fallidos: " << fallidos << "\n";
+        return fallidos == 0 ? 0 : 2;
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef ARCHIVO_MAPEADO_H
+#define ARCHIVO_MAPEADO_H
+
+#include <cstddef>
+
+// Proyeccion de solo lectura de un archivo completo en memoria (mmap).
+// Las paginas vienen directamente de la cache del sistema, sin copia ni read().
+class ArchivoMapeado {
+private:
+    void* datos;
+    size_t longitud;
+
+public:
+    ArchivoMapeado();
+    ~ArchivoMapeado();
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    bool abrir(const char* filename, bool secuencial = true);
+    void cerrar();
+
+    const unsigned char* data() const { return static_cast<const unsigned char*>(datos); }
+    size_t size() const { return longitud; }
+    bool abierto() const { return datos != nullptr; }
+};
+
+#endif
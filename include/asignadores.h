@@ -0,0 +1,154 @@
+#ifndef ASIGNADORES_H
+#define ASIGNADORES_H
+
+#include "buddy_system.h"
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Estrategia de memoria para los buffers de salida de los kernels. Todos los
+// kernels reciben un AsignadorImagen&, asi una estrategia nueva se prueba sin
+// duplicar cada funcion.
+class AsignadorImagen {
+public:
+    virtual ~AsignadorImagen() {}
+    // nullptr si no hay memoria suficiente
+    virtual unsigned char* asignar(size_t n) = 0;
+    virtual void liberar(unsigned char* p) = 0;
+    virtual const char* nombre() const = 0;
+};
+
+// new[] / delete[]
+class AsignadorHeap : public AsignadorImagen {
+public:
+    unsigned char* asignar(size_t n) override;
+    void liberar(unsigned char* p) override;
+    const char* nombre() const override { return "heap"; }
+};
+
+// Bloques del Buddy System (no es seguro entre hilos, igual que BuddySystem)
+class AsignadorBuddy : public AsignadorImagen {
+private:
+    BuddySystem& buddy;
+
+public:
+    explicit AsignadorBuddy(BuddySystem& buddy) : buddy(buddy) {}
+    unsigned char* asignar(size_t n) override;
+    void liberar(unsigned char* p) override;
+    const char* nombre() const override { return "buddy"; }
+};
+
+// Arena de puntero creciente sobre un bloque fijo: asignar es sumar un desplazamiento.
+// liberar solo recupera la ultima asignacion (orden LIFO); el resto vuelve con reiniciar().
+class AsignadorArena : public AsignadorImagen {
+private:
+    unsigned char* bloque;
+    size_t capacidad;
+    size_t usado;
+    size_t pico;
+    std::vector<size_t> inicios;   // Desplazamiento previo a cada asignacion viva
+
+public:
+    explicit AsignadorArena(size_t capacidad);
+    ~AsignadorArena() override;
+    AsignadorArena(const AsignadorArena&) = delete;
+    AsignadorArena& operator=(const AsignadorArena&) = delete;
+
+    unsigned char* asignar(size_t n) override;
+    void liberar(unsigned char* p) override;
+    const char* nombre() const override { return "arena"; }
+
+    void reiniciar();
+    size_t memoriaUsada() const { return usado; }
+    size_t picoMemoria() const { return pico; }
+};
+
+// Pool por hilo con clases de tamano potencia de dos: un buffer liberado queda en
+// la lista del hilo que lo libera y se reutiliza en la siguiente asignacion de la
+// misma clase, sin pasar por el asignador del sistema.
+class AsignadorPoolHilo : public AsignadorImagen {
+private:
+    static const int NUM_CLASES = 48;
+    std::vector<unsigned char*> libres[NUM_CLASES];
+    size_t maximoPorClase;
+
+    AsignadorPoolHilo();
+
+public:
+    ~AsignadorPoolHilo() override;
+    AsignadorPoolHilo(const AsignadorPoolHilo&) = delete;
+    AsignadorPoolHilo& operator=(const AsignadorPoolHilo&) = delete;
+
+    // Instancia propia del hilo que llama
+    static AsignadorPoolHilo& delHilo();
+
+    unsigned char* asignar(size_t n) override;
+    void liberar(unsigned char* p) override;
+    const char* nombre() const override { return "pool"; }
+
+    // Devuelve al sistema todos los buffers guardados por este hilo
+    void vaciar();
+};
+
+// Pool compartido entre hilos para buffers de imagen que se repiten (un lote de
+// fotos de la misma resolucion). Las clases de tamano son cuatro por cada potencia
+// de dos, asi el desperdicio es menor al 25%. Los buffers guardados no pasan de
+// 'limite' bytes (se descartan primero los mas viejos) y los que llevan mas de
+// 'inactividad' sin usarse se devuelven al sistema en la siguiente operacion.
+class PoolBuffers : public AsignadorImagen {
+private:
+    struct Libre {
+        unsigned char* base;
+        std::chrono::steady_clock::time_point liberado;
+    };
+
+    static const int NUM_CLASES = 160;
+    std::deque<Libre> libres[NUM_CLASES];   // Del mas viejo al mas reciente
+    size_t limite;
+    std::chrono::steady_clock::duration inactividad;
+    std::chrono::steady_clock::time_point ultimaRevision;
+    size_t bytesGuardados;
+    size_t picoGuardados;
+    size_t aciertos, fallos, recortados;
+    mutable std::mutex mutex;
+
+    void descartar(int clase);
+    void recortarInactivos(std::chrono::steady_clock::time_point ahora);
+
+public:
+    PoolBuffers(size_t limite, std::chrono::milliseconds inactividad);
+    ~PoolBuffers() override;
+    PoolBuffers(const PoolBuffers&) = delete;
+    PoolBuffers& operator=(const PoolBuffers&) = delete;
+
+    unsigned char* asignar(size_t n) override;
+    void liberar(unsigned char* p) override;
+    const char* nombre() const override { return "compartido"; }
+
+    // Devuelve al sistema todos los buffers guardados
+    void vaciar();
+
+    size_t numAciertos() const;
+    size_t numFallos() const;
+    size_t numRecortados() const;   // Descartados por el limite o por inactividad
+    size_t memoriaGuardada() const;
+    size_t picoMemoria() const;
+};
+
+// Buffer provisto por quien llama: se entrega una sola vez y solo si alcanza
+class AsignadorExterno : public AsignadorImagen {
+private:
+    unsigned char* buffer;
+    size_t capacidad;
+    bool ocupado;
+
+public:
+    AsignadorExterno(unsigned char* buffer, size_t capacidad);
+    unsigned char* asignar(size_t n) override;
+    void liberar(unsigned char* p) override;
+    const char* nombre() const override { return "externo"; }
+};
+
+#endif
@@ -1,33 +1,42 @@
-#ifndef BUDDY_SYSTEM_H
-#define BUDDY_SYSTEM_H
-
-#include <vector>
-#include <cstddef>
-
-struct BuddyBlock {
-    size_t size;
-    bool isFree;
-    size_t offset;
-    void* ptr;
-};
-
-class BuddySystem {
-private:
-    size_t totalSize;
-    std::vector<BuddyBlock> blocks;
-    std::vector<void*> allocatedPointers;
-
-    size_t nextPowerOfTwo(size_t size);
-    void splitBlock(size_t index, size_t size);
-    void mergeBlocks();
-
-public:
-    explicit BuddySystem(size_t totalSize);
-    ~BuddySystem();
-    
-    void* allocate(size_t size);
-    void free(void* ptr);
-    void printMemoryStatus() const;
-};
-
+#ifndef BUDDY_SYSTEM_H
+#define BUDDY_SYSTEM_H
+
+#include <vector>
+#include <cstddef>
+
+struct BuddyBlock {
+    size_t size;
+    bool isFree;
+    size_t offset;
+    void* ptr;
+};
+
+class BuddySystem {
+private:
+    size_t totalSize;
+    std::vector<BuddyBlock> blocks;
+    std::vector<void*> allocatedPointers;
+    size_t bytesEnUso;   // Suma de los bloques ocupados (ya redondeados a potencia de dos)
+    size_t picoEnUso;
+    bool detallado;      // Informar cada operacion por stdout
+
+    size_t nextPowerOfTwo(size_t size);
+    void splitBlock(size_t index, size_t size);
+    void mergeBlocks();
+
+public:
+    // Con detallado = false no se informa cada asignacion, division, liberacion y
+    // fusion por stdout (los errores siguen en stderr); lo usan las mediciones
+    explicit BuddySystem(size_t totalSize, bool detallado = true);
+    ~BuddySystem();
+    
+    void* allocate(size_t size);
+    void free(void* ptr);
+    void printMemoryStatus() const;
+
+    size_t memoriaEnUso() const { return bytesEnUso; }
+    size_t picoMemoria() const { return picoEnUso; }
+    void reiniciarPico() { picoEnUso = bytesEnUso; }
+};
+
 #endif
\ No newline at end of file
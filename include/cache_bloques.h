@@ -0,0 +1,63 @@
+#ifndef CACHE_BLOQUES_H
+#define CACHE_BLOQUES_H
+
+#include "grafo_operaciones.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct ClaveBloque {
+    uint64_t origen;          // Hash del contenido de la imagen fuente
+    uint64_t transformacion;  // Hash de las operaciones e interpolacion
+    int bx, by;               // Coordenada del bloque en la salida
+
+    bool operator==(const ClaveBloque& o) const {
+        return origen == o.origen && transformacion == o.transformacion && bx == o.bx && by == o.by;
+    }
+};
+
+struct HashClaveBloque {
+    size_t operator()(const ClaveBloque& c) const;
+};
+
+struct EstadisticasCache {
+    size_t aciertos = 0, fallos = 0, desalojos = 0;
+    size_t bytesUsados = 0, bloques = 0;
+};
+
+// Cache en memoria de bloques ya renderizados, con presupuesto en bytes y
+// desalojo LRU. Los bloques se comparten con shared_ptr, asi que un bloque
+// desalojado sigue siendo valido para quien ya lo tenga.
+class CacheBloques {
+private:
+    using Entrada = std::pair<ClaveBloque, std::shared_ptr<const BufferImagen>>;
+
+    size_t presupuesto;
+    std::list<Entrada> lru;   // Mas reciente al principio
+    std::unordered_map<ClaveBloque, std::list<Entrada>::iterator, HashClaveBloque> indice;
+    EstadisticasCache stats;
+    mutable std::mutex mutex;
+
+    void desalojarHasta(size_t limite);
+
+public:
+    explicit CacheBloques(size_t presupuestoBytes);
+
+    std::shared_ptr<const BufferImagen> buscar(const ClaveBloque& clave);
+    void insertar(const ClaveBloque& clave, std::shared_ptr<const BufferImagen> bloque);
+
+    // Devuelve el bloque (bx, by) de la salida del grafo, calculandolo si no estaba.
+    // 'plan' y 'huellaPlan' vienen de planificar() y huellaTransformacion(plan): un
+    // acierto solo consulta el indice, sin volver a leer la cabecera de la fuente.
+    std::shared_ptr<const BufferImagen> obtenerBloque(const GrafoOperaciones& grafo, const std::vector<EtapaPlan>& plan,
+                                                      uint64_t huellaPlan, int bx, int by);
+    // Arma una region de la salida a partir de los bloques que la cubren; planifica una sola vez
+    bool renderizarRegion(const GrafoOperaciones& grafo, const Rectangulo& region, BufferImagen& resultado);
+
+    void limpiar();
+    EstadisticasCache estadisticas() const;
+};
+
+#endif
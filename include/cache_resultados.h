@@ -0,0 +1,53 @@
+#ifndef CACHE_RESULTADOS_H
+#define CACHE_RESULTADOS_H
+
+#include "formatos_imagen.h"
+#include "transformacion_afin.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Cache en disco de imagenes ya codificadas, direccionada por contenido: la
+// clave es la huella de los bytes de entrada junto con los parametros de la
+// transformacion. Cada resultado se escribe en un temporal y se renombra, asi
+// que un proceso interrumpido nunca deja una entrada a medias. Si el directorio
+// supera el limite se borran los resultados usados hace mas tiempo.
+class CacheResultados {
+private:
+    std::string directorio;
+    size_t limiteBytes;
+    size_t bytesUsados;
+    std::mutex mutex;
+    std::atomic<size_t> aciertos;
+    std::atomic<size_t> fallos;
+
+    std::string rutaEntrada(const std::string& clave) const;
+    void recortar();
+
+public:
+    CacheResultados(const std::string& directorio, size_t limiteBytes);
+
+    // Crea el directorio si hace falta y mide lo que ya ocupa
+    bool preparar();
+
+    // Huella de los bytes del archivo de entrada (cadena vacia si no se pudo leer)
+    static std::string huellaEntrada(const std::string& entrada);
+    static std::string calcularClave(const std::string& huella, const std::string& parametros);
+    // Copia el resultado guardado a destino; false si no esta
+    bool recuperar(const std::string& clave, const std::string& destino);
+    // Guarda una copia del archivo ya escrito en origen
+    bool almacenar(const std::string& clave, const std::string& origen);
+
+    size_t numAciertos() const { return aciertos; }
+    size_t numFallos() const { return fallos; }
+};
+
+// Texto que identifica una transformacion y su codificacion para calcularClave.
+// 'bitsMuestra' es el tipo de muestra con el que se transforma (8, 16 o 32 para
+// float): una misma entrada de 16 bits da un PNG de 16 bits en el modo de una
+// imagen y uno de 8 bits en el lote, y no pueden compartir entrada.
+std::string parametrosResultado(const char* modo, int bitsMuestra, float angle, float scaleFactor, const FondoTransformacion& fondo,
+                                Interpolacion interpolacion, FormatoImagen formato, const OpcionesGuardado& opciones);
+
+#endif
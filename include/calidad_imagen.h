@@ -0,0 +1,29 @@
+#ifndef CALIDAD_IMAGEN_H
+#define CALIDAD_IMAGEN_H
+
+#include <cstdint>
+#include <vector>
+
+// Entradas sinteticas deterministas para comparar kernels entre versiones
+enum class PatronSintetico {
+    Degradado,   // Rampas suaves en x e y, distintas por canal
+    Tablero,     // Casillas de 8x8 blanco/negro (bordes duros, peor caso del remuestreo)
+    Ruido,       // Ruido uniforme con semilla fija
+    Zonas        // Anillos concentricos de frecuencia creciente (muestra el aliasing)
+};
+
+const char* nombrePatron(PatronSintetico patron);
+std::vector<unsigned char> generarImagenSintetica(PatronSintetico patron, int width, int height, int channels,
+                                                  uint32_t semilla = 12345);
+
+struct MetricasCalidad {
+    double psnr = 0.0;          // dB; infinito si las imagenes son identicas
+    double ssim = 0.0;          // 1.0 = identicas
+    int diferenciaMaxima = 0;   // Mayor |a - b| entre muestras
+};
+
+// Compara dos imagenes del mismo tamano y canales. SSIM se calcula por canal
+// en ventanas de 8x8 con paso 4 y se promedia.
+MetricasCalidad compararImagenes(const unsigned char* a, const unsigned char* b, int width, int height, int channels);
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef COLA_ACOTADA_H
+#define COLA_ACOTADA_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Cola MPMC acotada sin bloqueos (esquema de Vyukov: cada celda lleva un
+// numero de secuencia que indica si esta libre u ocupada para la vuelta actual).
+// encolar() espera mientras la cola esta llena, lo que da contrapresion a la
+// etapa productora; desencolar() devuelve false cuando la cola se cerro y vacio.
+template <typename T>
+class ColaAcotada {
+private:
+    struct Celda {
+        std::atomic<size_t> secuencia;
+        T valor;
+    };
+
+    std::unique_ptr<Celda[]> celdas;
+    size_t mascara;
+    alignas(64) std::atomic<size_t> posEncolar;
+    alignas(64) std::atomic<size_t> posDesencolar;
+    alignas(64) std::atomic<bool> cerrada;
+
+    static void esperar(int& intentos) {
+        if (++intentos < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+public:
+    explicit ColaAcotada(size_t capacidad) : posEncolar(0), posDesencolar(0), cerrada(false) {
+        size_t n = 2;
+        while (n < capacidad) n <<= 1;
+        celdas.reset(new Celda[n]);
+        mascara = n - 1;
+        for (size_t i = 0; i < n; ++i) {
+            celdas[i].secuencia.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ColaAcotada(const ColaAcotada&) = delete;
+    ColaAcotada& operator=(const ColaAcotada&) = delete;
+
+    bool intentarEncolar(T& valor) {
+        size_t pos = posEncolar.load(std::memory_order_relaxed);
+        for (;;) {
+            Celda& celda = celdas[pos & mascara];
+            size_t sec = celda.secuencia.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(sec) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (posEncolar.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    celda.valor = std::move(valor);
+                    celda.secuencia.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;   // Llena
+            } else {
+                pos = posEncolar.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool intentarDesencolar(T& valor) {
+        size_t pos = posDesencolar.load(std::memory_order_relaxed);
+        for (;;) {
+            Celda& celda = celdas[pos & mascara];
+            size_t sec = celda.secuencia.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(sec) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (posDesencolar.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    valor = std::move(celda.valor);
+                    celda.secuencia.store(pos + mascara + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;   // Vacia
+            } else {
+                pos = posDesencolar.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void encolar(T valor) {
+        int intentos = 0;
+        while (!intentarEncolar(valor)) {
+            esperar(intentos);
+        }
+    }
+
+    bool desencolar(T& valor) {
+        int intentos = 0;
+        for (;;) {
+            if (intentarDesencolar(valor)) return true;
+            if (cerrada.load(std::memory_order_acquire)) {
+                // Un ultimo intento: pudo entrar algo justo antes del cierre
+                return intentarDesencolar(valor);
+            }
+            esperar(intentos);
+        }
+    }
+
+    // Los productores ya no agregaran elementos
+    void cerrar() { cerrada.store(true, std::memory_order_release); }
+};
+
+#endif
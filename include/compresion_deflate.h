@@ -0,0 +1,67 @@
+#ifndef COMPRESION_DEFLATE_H
+#define COMPRESION_DEFLATE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Esfuerzo de compresion (equivalente a los niveles de zlib)
+enum class NivelCompresion {
+    Almacenar = 0,   // Bloques sin comprimir, lo mas rapido posible
+    Rapido = 1,
+    Normal = 6,
+    Maximo = 9
+};
+
+NivelCompresion nivelDesdeEntero(int nivel);
+
+uint32_t calcularAdler32(uint32_t adler, const unsigned char* datos, size_t n);
+uint32_t combinarAdler32(uint32_t adler1, uint32_t adler2, size_t longitud2);
+uint32_t calcularCRC32(uint32_t crc, const unsigned char* datos, size_t n);
+
+// Compresor deflate incremental (RFC 1951) con codigos Huffman fijos.
+// Los datos se entregan por partes y la salida se va agregando a medida
+// que hay suficiente ventana para buscar coincidencias.
+class CompresorDeflate {
+private:
+    NivelCompresion nivel;
+    int longitudCadena;      // Candidatos a revisar por posicion
+    int longitudSuficiente;  // Coincidencia con la que se deja de buscar
+    bool evaluacionPerezosa;
+
+    std::vector<unsigned char> datos;  // Ventana + datos pendientes
+    int64_t base;                      // Posicion absoluta de datos[0]
+    int64_t pos;                       // Siguiente posicion a codificar
+    int64_t insertado;                 // Siguiente posicion a insertar en el hash
+    std::vector<int64_t> cabeza;
+    std::vector<int64_t> previo;
+
+    uint64_t bits;
+    int numBits;
+    bool bloqueAbierto;
+
+    int64_t fin() const { return base + static_cast<int64_t>(datos.size()); }
+    void escribirBits(uint32_t valor, int n, std::vector<unsigned char>& salida);
+    void escribirCodigo(uint32_t codigo, int n, std::vector<unsigned char>& salida);
+    void alinearByte(std::vector<unsigned char>& salida);
+    void escribirLiteral(int simbolo, std::vector<unsigned char>& salida);
+    void escribirCoincidencia(int longitud, int distancia, std::vector<unsigned char>& salida);
+    void insertarHasta(int64_t limite);
+    int buscarCoincidencia(int64_t p, int& distancia);
+    void codificar(int64_t limite, std::vector<unsigned char>& salida);
+    void escribirBloquesAlmacenados(int64_t limite, bool final, std::vector<unsigned char>& salida);
+    void cerrarBloque(std::vector<unsigned char>& salida);
+    void deslizarVentana();
+
+public:
+    explicit CompresorDeflate(NivelCompresion nivel);
+
+    // Usa los datos como historial previo sin emitirlos (encadenado entre bloques)
+    void precargarDiccionario(const unsigned char* dic, size_t n);
+    void comprimir(const unsigned char* entrada, size_t n, std::vector<unsigned char>& salida);
+    // Vaciado sincronizado: deja la salida alineada a byte sin cerrar el flujo
+    void vaciar(std::vector<unsigned char>& salida);
+    void finalizar(std::vector<unsigned char>& salida);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef CONTADORES_HARDWARE_H
+#define CONTADORES_HARDWARE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum EventoHardware {
+    EVENTO_CICLOS = 0,
+    EVENTO_INSTRUCCIONES,
+    EVENTO_FALLOS_LLC,
+    EVENTO_FALLOS_DTLB,
+    EVENTO_FALLOS_SALTO,
+    NUM_EVENTOS_HARDWARE
+};
+
+struct LecturaContadores {
+    uint64_t valores[NUM_EVENTOS_HARDWARE] = {};
+    bool validos[NUM_EVENTOS_HARDWARE] = {};
+};
+
+// Contadores de hardware con perf_event_open (solo espacio de usuario).
+// Se abren para todos los hilos que existen al llamar a abrir() (incluidos los
+// del planificador) y se heredan a los hilos que se creen despues. Si el
+// kernel no los permite, disponible() es false y motivo() explica por que.
+class ContadoresHardware {
+private:
+    std::vector<int> descriptores[NUM_EVENTOS_HARDWARE];
+    bool disponibles[NUM_EVENTOS_HARDWARE];
+    std::string error;
+
+public:
+    ContadoresHardware();
+    ~ContadoresHardware();
+    ContadoresHardware(const ContadoresHardware&) = delete;
+    ContadoresHardware& operator=(const ContadoresHardware&) = delete;
+
+    bool abrir();
+    bool disponible() const;
+    const std::string& motivo() const { return error; }
+    // Suma de todos los hilos, escalada si el kernel multiplexo los contadores
+    LecturaContadores leer() const;
+};
+
+LecturaContadores diferenciaContadores(const LecturaContadores& fin, const LecturaContadores& inicio);
+
+// Mide una etapa; con contadores nulos o no disponibles no hace nada
+class MedidorContadores {
+private:
+    const ContadoresHardware* contadores;
+    std::string nombre;
+    LecturaContadores inicio;
+
+public:
+    MedidorContadores(const ContadoresHardware* contadores, const std::string& nombre);
+    // Imprime IPC y fallos por cada mil instrucciones de la etapa
+    void terminar();
+};
+
+#endif
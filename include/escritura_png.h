@@ -0,0 +1,71 @@
+#ifndef ESCRITURA_PNG_H
+#define ESCRITURA_PNG_H
+
+#include "compresion_deflate.h"
+#include <cstdio>
+#include <vector>
+
+enum class FiltroPNG {
+    Ninguno = 0,
+    Sub = 1,
+    Arriba = 2,
+    Promedio = 3,
+    Paeth = 4,
+    Adaptativo = 5   // Elige por fila el filtro con menor suma de diferencias absolutas
+};
+
+struct OpcionesPNG {
+    NivelCompresion nivel = NivelCompresion::Normal;
+    FiltroPNG filtro = FiltroPNG::Adaptativo;
+    int hilos = 0;   // Bloques a comprimir a la vez (0 = hilos del planificador, 1 = sin paralelismo)
+};
+
+bool filtroDesdeTexto(const char* texto, FiltroPNG& filtro);
+
+// Codificador PNG incremental: recibe la imagen fila por fila y escribe
+// los bloques IDAT a medida que se comprimen, sin guardar la imagen completa.
+class EscritorPNG {
+private:
+    FILE* archivo;
+    int width, height, channels;
+    int bytesPixel;
+    int filasEscritas;
+    OpcionesPNG opciones;
+    CompresorDeflate compresor;
+    uint32_t adler;
+    std::vector<unsigned char> filaAnterior;
+    std::vector<unsigned char> filtrada;
+    std::vector<unsigned char> comprimido;
+
+    bool escribirBloque(const char* tipo, const unsigned char* datos, size_t n);
+    bool volcarIDAT(bool forzar);
+
+public:
+    EscritorPNG();
+    ~EscritorPNG();
+
+    // bitsMuestra es 8 o 16; con 16 las filas llegan con cada muestra en big-endian
+    bool abrir(const char* filename, int width, int height, int channels, const OpcionesPNG& opciones,
+               int bitsMuestra = 8);
+    bool escribirFila(const unsigned char* fila);
+    bool cerrar();
+};
+
+FiltroPNG elegirFiltroPNG(const unsigned char* fila, const unsigned char* anterior, size_t bytesFila, int bpp);
+// Escribe en salida el byte de tipo de filtro seguido de la fila filtrada
+void filtrarFilaPNG(const unsigned char* fila, const unsigned char* anterior, size_t bytesFila,
+                    int bpp, FiltroPNG filtro, unsigned char* salida);
+
+// Divide las filas en bloques independientes que se comprimen en paralelo
+// (cada bloque usa como diccionario los ultimos 32 KB del anterior y termina
+// con un vaciado sincronizado), y los concatena en un unico flujo IDAT.
+bool guardarImagenPNGParalelo(const char* filename, const unsigned char* image, int width, int height, int channels,
+                              const OpcionesPNG& opciones, int hilos, int bitsMuestra = 8);
+
+bool guardarImagenPNG(const char* filename, const unsigned char* image, int width, int height, int channels,
+                      const OpcionesPNG& opciones);
+// 16 bits por muestra, en el orden de la memoria (se pasan a big-endian al codificar)
+bool guardarImagenPNG16(const char* filename, const uint16_t* image, int width, int height, int channels,
+                        const OpcionesPNG& opciones);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef ESPACIO_COLOR_H
+#define ESPACIO_COLOR_H
+
+#include <cstdint>
+
+// Conversion entre sRGB de 8 bits y luz lineal de 16 bits (0..65535) con tablas.
+// La ida tiene una entrada por valor sRGB; la vuelta se indexa con los 12 bits
+// altos del valor lineal redondeado (4097 entradas, 4 KB, cabe en L1), suficiente
+// para que cada valor sRGB vuelva exactamente a si mismo.
+struct TablasColor {
+    uint16_t aLineal[256];
+    uint8_t aSrgb[4097];
+
+    TablasColor();
+
+    // 'lineal' no puede ser negativo (es un promedio con pesos positivos)
+    uint8_t srgbDesdeLineal(float lineal) const {
+        unsigned indice = static_cast<unsigned>(lineal + 8.0f) >> 4;
+        return aSrgb[indice < 4096 ? indice : 4096];
+    }
+};
+
+// Curvas exactas con valores normalizados (1 = blanco); se usan para construir
+// las tablas y para las muestras de 16 bits y float
+float srgbALineal(float c);
+float linealASrgb(float l);
+
+// Se construyen la primera vez que se piden
+inline const TablasColor& tablasColor() {
+    static const TablasColor tablas;
+    return tablas;
+}
+
+#endif
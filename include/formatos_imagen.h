@@ -0,0 +1,43 @@
+#ifndef FORMATOS_IMAGEN_H
+#define FORMATOS_IMAGEN_H
+
+#include "escritura_png.h"
+#include <string>
+
+enum class FormatoImagen {
+    Automatico,   // Segun la extension del archivo (PNG si no se reconoce)
+    PNG,
+    JPEG,
+    BMP,
+    TGA,
+    PNM,          // PPM (P6) para color, PGM (P5) para gris
+    QOI,
+    HDR           // Radiance RGBE en float (sin alfa)
+};
+
+struct OpcionesGuardado {
+    FormatoImagen formato = FormatoImagen::Automatico;
+    int calidadJPEG = 90;
+    OpcionesPNG png;
+};
+
+bool formatoDesdeTexto(const char* texto, FormatoImagen& formato);
+FormatoImagen formatoDesdeExtension(const std::string& filename);
+const char* extensionFormato(FormatoImagen formato);
+// Formato con el que se escribira filename; si no coincide con su extension,
+// nombreFinal recibe el nombre con la extension correcta agregada
+FormatoImagen resolverFormatoSalida(const std::string& filename, FormatoImagen pedido, std::string& nombreFinal);
+
+bool guardarImagenPNM(const char* filename, const unsigned char* image, int width, int height, int channels);
+bool guardarImagenQOI(const char* filename, const unsigned char* image, int width, int height, int channels);
+bool guardarImagenFormato(const char* filename, const unsigned char* image, int width, int height, int channels,
+                          FormatoImagen formato, const OpcionesGuardado& opciones);
+// Muestras de 16 bits: PNG las conserva, HDR las pasa a float y el resto a 8 bits.
+bool guardarImagenFormato16(const char* filename, const uint16_t* image, int width, int height, int channels,
+                            FormatoImagen formato, const OpcionesGuardado& opciones);
+// Muestras float en luz lineal (como las devuelve stbi_loadf): HDR las guarda tal
+// cual; los demas formatos reciben la curva inversa de stbi_loadf (gamma 2.2).
+bool guardarImagenFormatoFlotante(const char* filename, const float* image, int width, int height, int channels,
+                                  FormatoImagen formato, const OpcionesGuardado& opciones);
+
+#endif
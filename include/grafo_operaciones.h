@@ -0,0 +1,93 @@
+#ifndef GRAFO_OPERACIONES_H
+#define GRAFO_OPERACIONES_H
+
+#include "transformacion_afin.h"
+#include "formatos_imagen.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct BufferImagen {
+    std::vector<unsigned char> pixeles;
+    int width = 0, height = 0, channels = 0;
+};
+
+const int TAMANO_BLOQUE_REGION = 256;
+
+enum class TipoOperacion { Rotar, Escalar, Recortar, Convertir };
+
+struct Operacion {
+    TipoOperacion tipo;
+    float valor = 0.0f;             // Angulo o factor de escala
+    int x = 0, y = 0, w = 0, h = 0; // Rectangulo de recorte
+    int canales = 0;                // Canales de destino al convertir
+};
+
+// Paso ya optimizado del plan de ejecucion
+struct EtapaPlan {
+    enum Tipo { Transformacion, Conversion } tipo;
+    MatrizAfin inversa;              // Destino -> fuente (solo Transformacion)
+    int width = 0, height = 0, channels = 0;   // Tamano de la salida de la etapa
+    int bloqueAncho = 0, bloqueAlto = 0;
+    int operacionesFusionadas = 0;
+};
+
+// Grafo lineal de operaciones que se arma sin ejecutar nada:
+//   GrafoOperaciones::cargar("a.jpg").rotar(30).escalar(0.5).recortar(...).guardar("b.png")
+// Al ejecutar, el planificador elimina las operaciones nulas (angulo 0, escala 1,
+// recorte completo, conversion a los mismos canales), fusiona las geometricas
+// consecutivas en una sola transformacion afin y elige el tamano de bloque.
+class GrafoOperaciones {
+private:
+    std::string archivoOrigen;
+    const unsigned char* memoriaOrigen;
+    int widthOrigen, heightOrigen, channelsOrigen;
+    std::vector<Operacion> operaciones;
+    Interpolacion modoInterpolacion;
+    mutable uint64_t huellaOrigenGuardada;
+    mutable bool huellaOrigenCalculada;
+
+    GrafoOperaciones();
+    bool dimensionesOrigen(int& width, int& height, int& channels) const;
+
+public:
+    static GrafoOperaciones cargar(const std::string& filename);
+    // La memoria debe seguir valida hasta ejecutar el grafo
+    static GrafoOperaciones desdeMemoria(const unsigned char* image, int width, int height, int channels);
+
+    GrafoOperaciones& rotar(float angle);
+    GrafoOperaciones& escalar(float scaleFactor);
+    GrafoOperaciones& recortar(int x, int y, int width, int height);
+    GrafoOperaciones& convertir(int channels);
+    GrafoOperaciones& interpolacion(Interpolacion modo);
+
+    const std::vector<Operacion>& listaOperaciones() const { return operaciones; }
+    bool planificar(std::vector<EtapaPlan>& plan, int& eliminadas) const;
+    std::string describirPlan() const;
+
+    bool ejecutar(BufferImagen& resultado) const;
+
+    // Renderizado bajo demanda: calcula solo 'region' de la salida final. La
+    // region se proyecta hacia atras etapa por etapa hasta el rectangulo minimo
+    // de la fuente, y solo ese rectangulo se lee y transforma.
+    bool tamanoSalida(int& width, int& height, int& channels) const;
+    bool ejecutarRegion(const Rectangulo& region, BufferImagen& resultado) const;
+    // Igual, con un plan ya calculado por planificar() para no repetirlo en cada bloque
+    bool ejecutarRegion(const std::vector<EtapaPlan>& plan, const Rectangulo& region, BufferImagen& resultado) const;
+    // Bloque (bx, by) de una cuadricula de TAMANO_BLOQUE_REGION pixeles sobre la salida
+    Rectangulo rectanguloBloque(int bx, int by) const;
+    bool ejecutarBloque(int bx, int by, BufferImagen& resultado) const;
+    bool ejecutarBloque(const std::vector<EtapaPlan>& plan, int bx, int by, BufferImagen& resultado) const;
+
+    // Identificadores para caches: hash del contenido de la fuente (se calcula una
+    // vez) y hash del plan optimizado, asi dos grafos equivalentes comparten entradas
+    uint64_t huellaOrigen() const;
+    uint64_t huellaTransformacion() const;
+    uint64_t huellaTransformacion(const std::vector<EtapaPlan>& plan) const;
+    bool guardar(const std::string& filename, const OpcionesGuardado& opciones = OpcionesGuardado()) const;
+};
+
+void convertirCanales(const unsigned char* image, int width, int height, int channels,
+                      unsigned char* destino, int canalesDestino);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef HASH_CONTENIDO_H
+#define HASH_CONTENIDO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hash no criptografico de 64 bits para identificar contenido (procesa 8 bytes por paso)
+uint64_t hashContenido(const void* datos, size_t n, uint64_t semilla = 0);
+uint64_t combinarHash(uint64_t a, uint64_t b);
+// Huella de 128 bits en hexadecimal (dos hashes con semillas distintas)
+std::string huellaHexadecimal(const void* datos, size_t n);
+
+#endif
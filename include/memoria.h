@@ -0,0 +1,47 @@
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <cstddef>
+#include <string>
+
+// Contadores del operator new/delete global (incluye new[] y los contenedores
+// de la biblioteca estandar; no incluye el malloc directo de stb)
+struct EstadisticasHeap {
+    size_t vivos = 0;          // Bytes asignados y aun no liberados
+    size_t pico = 0;           // Maximo de vivos desde el ultimo reinicio
+    size_t asignaciones = 0;   // Llamadas a new desde el inicio
+};
+
+EstadisticasHeap estadisticasHeap();
+void reiniciarPicoHeap();   // El pico vuelve a los bytes vivos actuales
+
+// Memoria residente actual segun /proc/self/statm
+size_t memoriaResidenteKB();
+// Pico de memoria residente (VmHWM de /proc/self/status)
+size_t picoResidenteKB();
+// Reinicia VmHWM escribiendo en /proc/self/clear_refs; false si el kernel no lo permite
+bool reiniciarPicoResidente();
+
+struct InformeFase {
+    std::string nombre;
+    size_t rssInicioKB = 0, rssFinKB = 0, picoRssKB = 0;
+    bool picoRssExacto = false;   // false: el pico es solo el maximo entre inicio y fin
+    size_t heapInicio = 0, heapFin = 0, picoHeap = 0;
+    size_t asignaciones = 0;
+};
+
+// Mide una fase: memoria residente al inicio y al final, pico residente y pico
+// del heap dentro de la fase. Las fases no deben solaparse porque los picos son globales.
+class MedidorFase {
+private:
+    InformeFase informe;
+    size_t asignacionesInicio;
+
+public:
+    explicit MedidorFase(const std::string& nombre);
+    InformeFase terminar();
+};
+
+void mostrarInformeFase(const InformeFase& informe);
+
+#endif
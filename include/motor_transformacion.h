@@ -0,0 +1,537 @@
+#ifndef MOTOR_TRANSFORMACION_H
+#define MOTOR_TRANSFORMACION_H
+
+#include "transformacion_afin.h"
+#include "asignadores.h"
+#include "planificador.h"
+#include "espacio_color.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <type_traits>
+
+// Motor unico de transformaciones geometricas. Todas las variantes (cualquier
+// AsignadorImagen, grafo de operaciones) pasan por transformarRegion, asi que
+// solo cambia la estrategia de memoria y no el algoritmo.
+
+// Version de la salida de los kernels. Se incrementa en el mismo commit que cambie
+// algun pixel de salida (junto con bench/referencias); la cache de resultados la
+// incluye en su clave para no devolver imagenes calculadas por kernels anteriores.
+// 2: bilineal unificado en el modo convencional (antes vecino con tamano truncado)
+// 3: bilineal con alfa premultiplicado en imagenes con canal alfa
+const int VERSION_KERNELS = 3;
+
+// ---- Tipos de muestra ----
+// Los kernels son plantillas sobre el tipo de cada canal: unsigned char (8 bits),
+// uint16_t (16 bits) o float. RasgosMuestra dice como se vuelve de la suma en float
+// al tipo del canal y cual es el valor de un alfa opaco.
+
+template <typename T>
+struct RasgosMuestra {
+    static constexpr float MAXIMO = 255.0f;
+    static T convertir(float v) { return static_cast<T>(v + 0.5f); }
+    static float acotar(float v) { return std::min(v, MAXIMO); }
+};
+
+template <>
+struct RasgosMuestra<uint16_t> {
+    static constexpr float MAXIMO = 65535.0f;
+    static uint16_t convertir(float v) { return static_cast<uint16_t>(v + 0.5f); }
+    static float acotar(float v) { return std::min(v, MAXIMO); }
+};
+
+// En float no se redondea ni se recorta: los valores de una imagen HDR pueden pasar de 1
+template <>
+struct RasgosMuestra<float> {
+    static constexpr float MAXIMO = 1.0f;
+    static float convertir(float v) { return v; }
+    static float acotar(float v) { return v; }
+};
+
+// Color de fondo (siempre de 8 bits) llevado al tipo de muestra
+template <typename T>
+void colorFondoMuestras(const FondoTransformacion& fondo, int channels, T* px) {
+    unsigned char color[4];
+    colorFondoPara(fondo, channels, color);
+    for (int c = 0; c < channels; ++c) px[c] = static_cast<T>(color[c] * (RasgosMuestra<T>::MAXIMO / 255.0f));
+}
+
+// ---- Politicas de interpolacion ----
+// La fuente es la ventana [fx0,fx1)x[fy0,fy1) de la imagen, con 'ancho' pixeles
+// por fila. dentro() dice si el punto (sx, sy) se puede muestrear sin salir de la
+// ventana; muestrearDentro escribe sus 'channels' valores en px sin revisar los
+// limites. Con Repetir, el vecino del ultimo pixel de una fila o columna es el primero.
+
+struct InterpolacionVecino {
+    // Zona valida de cada coordenada: [f0 + LIMITE_INFERIOR, f1 + LIMITE_SUPERIOR)
+    static constexpr double LIMITE_INFERIOR = -0.5;
+    static constexpr double LIMITE_SUPERIOR = -0.5;
+
+    static bool dentro(int fx0, int fy0, int fx1, int fy1, float sx, float sy) {
+        int srcX = static_cast<int>(std::round(sx));
+        int srcY = static_cast<int>(std::round(sy));
+        return srcX >= fx0 && srcX < fx1 && srcY >= fy0 && srcY < fy1;
+    }
+
+    template <bool Repetir, typename T>
+    static void muestrearDentro(const T* image, int fx0, int fy0, int fx1, int fy1, int ancho, int channels,
+                                float sx, float sy, T* px) {
+        int srcX = static_cast<int>(std::round(sx));
+        int srcY = static_cast<int>(std::round(sy));
+        if (srcX >= fx1) srcX = Repetir ? fx0 : fx1 - 1;
+        if (srcY >= fy1) srcY = Repetir ? fy0 : fy1 - 1;
+        std::memcpy(px, image + (static_cast<size_t>(srcY - fy0) * ancho + (srcX - fx0)) * channels,
+                    channels * sizeof(T));
+    }
+};
+
+struct InterpolacionBilineal {
+    static constexpr double LIMITE_INFERIOR = 0.0;
+    static constexpr double LIMITE_SUPERIOR = 0.0;
+
+    static bool dentro(int fx0, int fy0, int fx1, int fy1, float sx, float sy) {
+        return sx >= fx0 && sx < fx1 && sy >= fy0 && sy < fy1;
+    }
+
+    // Los cuatro vecinos de (sx, sy) y sus pesos
+    template <typename T>
+    struct Vecinos {
+        const T *p11, *p21, *p12, *p22;
+        float w11, w21, w12, w22;
+    };
+
+    template <bool Repetir, typename T>
+    static Vecinos<T> vecinos(const T* image, int fx0, int fy0, int fx1, int fy1, int ancho, int channels,
+                              float sx, float sy) {
+        int xa = static_cast<int>(sx);
+        int ya = static_cast<int>(sy);
+        int xb = xa + 1 < fx1 ? xa + 1 : (Repetir ? fx0 : fx1 - 1);
+        int yb = ya + 1 < fy1 ? ya + 1 : (Repetir ? fy0 : fy1 - 1);
+        float dx = sx - xa;
+        float dy = sy - ya;
+        Vecinos<T> v;
+        v.p11 = image + (static_cast<size_t>(ya - fy0) * ancho + (xa - fx0)) * channels;
+        v.p21 = image + (static_cast<size_t>(ya - fy0) * ancho + (xb - fx0)) * channels;
+        v.p12 = image + (static_cast<size_t>(yb - fy0) * ancho + (xa - fx0)) * channels;
+        v.p22 = image + (static_cast<size_t>(yb - fy0) * ancho + (xb - fx0)) * channels;
+        v.w11 = (1 - dx) * (1 - dy);
+        v.w21 = dx * (1 - dy);
+        v.w12 = (1 - dx) * dy;
+        v.w22 = dx * dy;
+        return v;
+    }
+
+    template <bool Repetir, typename T>
+    static void muestrearDentro(const T* image, int fx0, int fy0, int fx1, int fy1, int ancho, int channels,
+                                float sx, float sy, T* px) {
+        const Vecinos<T> v = vecinos<Repetir>(image, fx0, fy0, fx1, fy1, ancho, channels, sx, sy);
+        const T *p11 = v.p11, *p21 = v.p21, *p12 = v.p12, *p22 = v.p22;
+        const float w11 = v.w11, w21 = v.w21, w12 = v.w12, w22 = v.w22;
+        if (channels == 2 || channels == 4) {
+            // Con los cuatro alfas iguales (lo comun: zonas opacas) el resultado es el mismo sin ponderar
+            const T a = p11[channels - 1];
+            if (a != p21[channels - 1] || a != p12[channels - 1] || a != p22[channels - 1]) {
+                muestrearPremultiplicado(p11, p21, p12, p22, w11, w21, w12, w22, channels, px);
+                return;
+            }
+            if (a == 0) {
+                std::memset(px, 0, channels * sizeof(T));
+                return;
+            }
+        }
+        for (int c = 0; c < channels; ++c) {
+            float v = w11 * p11[c] + w12 * p12[c] + w21 * p21[c] + w22 * p22[c];
+            px[c] = RasgosMuestra<T>::convertir(v);
+        }
+    }
+
+    // Con alfa (gris+alfa o RGBA) cada vecino pesa tambien segun su alfa: es
+    // premultiplicar, interpolar y volver a dividir en un solo paso, sin pasadas
+    // extra. Asi un pixel transparente no tine el borde con su color.
+    template <typename T>
+    static void muestrearPremultiplicado(const T* p11, const T* p21, const T* p12, const T* p22,
+                                         float w11, float w21, float w12, float w22, int channels, T* px) {
+        const int ca = channels - 1;
+        const float a11 = w11 * p11[ca], a21 = w21 * p21[ca], a12 = w12 * p12[ca], a22 = w22 * p22[ca];
+        const float alfa = a11 + a21 + a12 + a22;
+        if (alfa <= 0) {
+            std::memset(px, 0, channels * sizeof(T));
+            return;
+        }
+        const float inversa = 1.0f / alfa;
+        // Como mucho tres canales de color con los mismos pesos: el compilador lo vectoriza
+        for (int c = 0; c < ca; ++c) {
+            float v = (a11 * p11[c] + a12 * p12[c] + a21 * p21[c] + a22 * p22[c]) * inversa;
+            px[c] = RasgosMuestra<T>::convertir(RasgosMuestra<T>::acotar(v));
+        }
+        px[ca] = RasgosMuestra<T>::convertir(alfa);
+    }
+};
+
+// Bilineal en luz lineal: los vecinos se pasan de sRGB a lineal, se promedian y el
+// resultado vuelve a sRGB. Evita que los bordes entre colores saturados y los
+// degradados se oscurezcan al reducir o rotar. El alfa ya es lineal y se interpola
+// tal cual; con alfa, el color se pondera ademas por el alfa de cada vecino como en
+// InterpolacionBilineal. En 8 bits la conversion usa tablasColor() y en 16 bits la
+// curva exacta; las muestras float ya son lineales (stbi_loadf) y no se convierten.
+struct InterpolacionBilinealLineal : InterpolacionBilineal {
+    // Conversion de un canal a luz lineal (escala 0..65535 en 8 bits, la del tipo en el resto) y de vuelta
+    struct ConversionTablas {
+        const TablasColor& tablas = tablasColor();
+        float aLineal(unsigned char v) const { return tablas.aLineal[v]; }
+        unsigned char aMuestra(float l) const { return tablas.srgbDesdeLineal(l); }
+    };
+    struct Conversion16 {
+        float aLineal(uint16_t v) const { return srgbALineal(v / 65535.0f) * 65535.0f; }
+        uint16_t aMuestra(float l) const {
+            return RasgosMuestra<uint16_t>::convertir(RasgosMuestra<uint16_t>::acotar(linealASrgb(l / 65535.0f) * 65535.0f));
+        }
+    };
+    struct ConversionIdentidad {
+        float aLineal(float v) const { return v; }
+        float aMuestra(float l) const { return l; }
+    };
+
+    template <bool Repetir, typename T>
+    static void muestrearDentro(const T* image, int fx0, int fy0, int fx1, int fy1, int ancho, int channels,
+                                float sx, float sy, T* px) {
+        typename std::conditional<std::is_same<T, unsigned char>::value, ConversionTablas,
+                 typename std::conditional<std::is_same<T, uint16_t>::value, Conversion16,
+                                           ConversionIdentidad>::type>::type conversion;
+        const Vecinos<T> v = vecinos<Repetir>(image, fx0, fy0, fx1, fy1, ancho, channels, sx, sy);
+        if (channels == 2 || channels == 4) {
+            const int ca = channels - 1;
+            const float a11 = v.w11 * v.p11[ca], a21 = v.w21 * v.p21[ca];
+            const float a12 = v.w12 * v.p12[ca], a22 = v.w22 * v.p22[ca];
+            const float alfa = a11 + a21 + a12 + a22;
+            if (alfa <= 0) {
+                std::memset(px, 0, channels * sizeof(T));
+                return;
+            }
+            const float inversa = 1.0f / alfa;
+            for (int c = 0; c < ca; ++c) {
+                float l = (a11 * conversion.aLineal(v.p11[c]) + a12 * conversion.aLineal(v.p12[c]) +
+                           a21 * conversion.aLineal(v.p21[c]) + a22 * conversion.aLineal(v.p22[c])) * inversa;
+                px[c] = conversion.aMuestra(l);
+            }
+            px[ca] = RasgosMuestra<T>::convertir(alfa);
+            return;
+        }
+        for (int c = 0; c < channels; ++c) {
+            float l = v.w11 * conversion.aLineal(v.p11[c]) + v.w12 * conversion.aLineal(v.p12[c]) +
+                      v.w21 * conversion.aLineal(v.p21[c]) + v.w22 * conversion.aLineal(v.p22[c]);
+            px[c] = conversion.aMuestra(l);
+        }
+    }
+};
+
+// Llama a funcion con una instancia de la politica que corresponde a 'interpolacion'
+template <typename Funcion>
+auto conInterpolacion(Interpolacion interpolacion, Funcion&& funcion) {
+    switch (interpolacion) {
+        case Interpolacion::Vecino: return funcion(InterpolacionVecino());
+        case Interpolacion::BilinealLineal: return funcion(InterpolacionBilinealLineal());
+        default: return funcion(InterpolacionBilineal());
+    }
+}
+
+// ---- Motor ----
+
+// Tramo [inicio, fin) de las columnas globales [gx0, gx1) de una fila cuyos puntos
+// (a*gx + baseX, d*gx + baseY) se pueden muestrear. Cada coordenada es monotona en
+// gx, asi que los puntos validos son contiguos. El tramo se estima de forma
+// analitica con un margen que cubre el redondeo en float, y despues se recorta con
+// dentro() para coincidir pixel a pixel con la prueba punto por punto.
+template <typename Interpolador>
+void tramoValido(float a, float d, float baseX, float baseY, int fx0, int fy0, int fx1, int fy1,
+                 int gx0, int gx1, int& inicio, int& fin) {
+    const double holgura = 0.05;
+    double desde = gx0, hasta = gx1;
+    auto restringir = [&](double pendiente, double base, double minimo, double maximo) {
+        if (pendiente == 0) return;   // Lo resuelve el recorte con dentro()
+        double t0 = (minimo - holgura - base) / pendiente, t1 = (maximo + holgura - base) / pendiente;
+        if (t0 > t1) std::swap(t0, t1);
+        desde = std::max(desde, t0);
+        hasta = std::min(hasta, t1);
+    };
+    restringir(a, baseX, fx0 + Interpolador::LIMITE_INFERIOR, fx1 + Interpolador::LIMITE_SUPERIOR);
+    restringir(d, baseY, fy0 + Interpolador::LIMITE_INFERIOR, fy1 + Interpolador::LIMITE_SUPERIOR);
+
+    inicio = fin = gx0;
+    if (hasta <= desde) return;
+    inicio = std::max(gx0, std::min(gx1, static_cast<int>(std::floor(desde))));
+    fin = std::max(inicio, std::min(gx1, static_cast<int>(std::ceil(hasta))));
+    while (inicio < fin && !Interpolador::dentro(fx0, fy0, fx1, fy1, a * inicio + baseX, d * inicio + baseY)) ++inicio;
+    while (fin > inicio && !Interpolador::dentro(fx0, fy0, fx1, fy1, a * (fin - 1) + baseX, d * (fin - 1) + baseY)) --fin;
+}
+
+// Pixel que corresponde a un punto fuera de la fuente segun el modo de fondo
+template <typename Interpolador, typename T>
+void muestrearFondo(const T* image, int fx0, int fy0, int fx1, int fy1, int ancho, int channels,
+                    float sx, float sy, const FondoTransformacion& fondo, T* px) {
+    if (fondo.modo == ModoFondo::ExtenderBorde) {
+        sx = std::min(std::max(sx, static_cast<float>(fx0)), static_cast<float>(fx1 - 1));
+        sy = std::min(std::max(sy, static_cast<float>(fy0)), static_cast<float>(fy1 - 1));
+        Interpolador::template muestrearDentro<false>(image, fx0, fy0, fx1, fy1, ancho, channels, sx, sy, px);
+    } else {
+        float w = static_cast<float>(fx1 - fx0), h = static_cast<float>(fy1 - fy0);
+        sx = std::fmod(sx - fx0, w);
+        sy = std::fmod(sy - fy0, h);
+        if (sx < 0) sx += w;
+        if (sy < 0) sy += h;
+        // El redondeo de fmod puede dar justo el ancho
+        sx = sx < w ? sx + fx0 : static_cast<float>(fx0);
+        sy = sy < h ? sy + fy0 : static_cast<float>(fy0);
+        Interpolador::template muestrearDentro<true>(image, fx0, fy0, fx1, fy1, ancho, channels, sx, sy, px);
+    }
+}
+
+// 'image' contiene solo regionFuente de la fuente y 'destino' recibe solo
+// regionDestino de la salida (ambas en coordenadas globales). Las coordenadas se
+// calculan siempre en el sistema global, asi una region da exactamente los mismos
+// valores que la imagen completa. pasoDestino son los bytes entre filas de destino
+// (0 = filas contiguas). T es el tipo de cada canal (unsigned char, uint16_t o float).
+// Cada fila se divide en el tramo que cae dentro de la fuente, que se muestrea sin
+// revisar limites, y las esquinas que quedan fuera, que reciben el fondo. Con
+// ExtenderBorde y Repetir los bordes son los de regionFuente.
+template <typename Interpolador, typename T>
+void transformarRegion(const T* image, const Rectangulo& regionFuente, int channels,
+                       const MatrizAfin& inversa, T* destino, const Rectangulo& regionDestino,
+                       int bloqueAncho, int bloqueAlto, size_t pasoDestino = 0,
+                       const FondoTransformacion& fondo = FondoTransformacion()) {
+    const float ia = static_cast<float>(inversa.a), ib = static_cast<float>(inversa.b), ic = static_cast<float>(inversa.c);
+    const float id = static_cast<float>(inversa.d), ie = static_cast<float>(inversa.e), iff = static_cast<float>(inversa.f);
+    const int fx0 = regionFuente.x, fy0 = regionFuente.y;
+    const int fx1 = fx0 + regionFuente.width, fy1 = fy0 + regionFuente.height;
+    const int anchoFuente = regionFuente.width;
+    const size_t bytesPixel = channels * sizeof(T);
+    if (pasoDestino == 0) pasoDestino = regionDestino.width * bytesPixel;
+
+    T colorFondo[4] = {};
+    colorFondoMuestras(fondo, channels, colorFondo);
+    const bool muestrearFuera = fondo.modo == ModoFondo::ExtenderBorde || fondo.modo == ModoFondo::Repetir;
+    const bool fondoCero = !muestrearFuera && colorFondo[0] == 0 && colorFondo[1] == 0 &&
+                           colorFondo[2] == 0 && colorFondo[3] == 0;
+
+    Planificador::global().paraCada2D(regionDestino.width, regionDestino.height, bloqueAncho, bloqueAlto,
+                                      [&](int x0, int y0, int x1, int y1) {
+        const int ox = regionDestino.x;
+        const int gx0 = x0 + ox, gx1 = x1 + ox;
+        for (int y = y0; y < y1; ++y) {
+            T* fila = reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(destino) + static_cast<size_t>(y) * pasoDestino);
+            int gy = y + regionDestino.y;
+            float baseX = ib * gy + ic;
+            float baseY = ie * gy + iff;
+            int inicio, fin;
+            tramoValido<Interpolador>(ia, id, baseX, baseY, fx0, fy0, fx1, fy1, gx0, gx1, inicio, fin);
+
+            auto rellenar = [&](int desde, int hasta) {
+                if (desde >= hasta) return;
+                if (fondoCero) {
+                    std::memset(fila + static_cast<size_t>(desde - ox) * channels, 0, (hasta - desde) * bytesPixel);
+                } else if (!muestrearFuera) {
+                    for (int gx = desde; gx < hasta; ++gx) std::memcpy(fila + static_cast<size_t>(gx - ox) * channels, colorFondo, bytesPixel);
+                } else {
+                    for (int gx = desde; gx < hasta; ++gx) {
+                        muestrearFondo<Interpolador>(image, fx0, fy0, fx1, fy1, anchoFuente, channels,
+                                                     ia * gx + baseX, id * gx + baseY, fondo,
+                                                     fila + static_cast<size_t>(gx - ox) * channels);
+                    }
+                }
+            };
+            rellenar(gx0, inicio);
+            if (fondo.modo == ModoFondo::Repetir) {
+                for (int gx = inicio; gx < fin; ++gx) {
+                    Interpolador::template muestrearDentro<true>(image, fx0, fy0, fx1, fy1, anchoFuente, channels,
+                                                                 ia * gx + baseX, id * gx + baseY,
+                                                                 fila + static_cast<size_t>(gx - ox) * channels);
+                }
+            } else {
+                for (int gx = inicio; gx < fin; ++gx) {
+                    Interpolador::template muestrearDentro<false>(image, fx0, fy0, fx1, fy1, anchoFuente, channels,
+                                                                  ia * gx + baseX, id * gx + baseY,
+                                                                  fila + static_cast<size_t>(gx - ox) * channels);
+                }
+            }
+            rellenar(fin, gx1);
+        }
+    });
+}
+
+// ---- Salida con canal alfa (ModoFondo::Alfa) ----
+// La fuente se trata como rodeada de pixeles transparentes: un punto de la salida
+// es visible si alguno de sus cuatro vecinos bilineales cae dentro, y el alfa del
+// borde queda suavizado en un pixel. El muestreo se hace con alfa premultiplicado
+// (cada vecino pesa segun su alfa), asi el color transparente no oscurece el borde.
+
+// Puntos con algun vecino dentro de la fuente
+struct BordeAlfa {
+    static constexpr double LIMITE_INFERIOR = -1.0;
+    static constexpr double LIMITE_SUPERIOR = 0.0;
+    static bool dentro(int fx0, int fy0, int fx1, int fy1, float sx, float sy) {
+        return sx > fx0 - 1 && sx < fx1 && sy > fy0 - 1 && sy < fy1;
+    }
+};
+
+// Puntos con los cuatro vecinos dentro de la fuente
+struct InteriorAlfa {
+    static constexpr double LIMITE_INFERIOR = 0.0;
+    static constexpr double LIMITE_SUPERIOR = -1.0;
+    static bool dentro(int fx0, int fy0, int fx1, int fy1, float sx, float sy) {
+        return sx >= fx0 && sx < fx1 - 1 && sy >= fy0 && sy < fy1 - 1;
+    }
+};
+
+// Canales de la salida: se agrega alfa a gris y RGB
+inline int canalesConAlfa(int channels) {
+    return (channels == 1 || channels == 3) ? channels + 1 : channels;
+}
+
+// Muestreo premultiplicado de (sx, sy); los vecinos fuera de la fuente son transparentes.
+// px recibe canalesConAlfa(channels) valores con alfa no premultiplicado.
+template <typename T>
+void muestrearBordeAlfa(const T* image, int fx0, int fy0, int fx1, int fy1, int ancho,
+                        int channels, float sx, float sy, T* px) {
+    const bool alfaFuente = channels == 2 || channels == 4;
+    const int canalesColor = alfaFuente ? channels - 1 : channels;
+    const float fxa = std::floor(sx), fya = std::floor(sy);
+    const int xa = static_cast<int>(fxa), ya = static_cast<int>(fya);
+    const float dx = sx - fxa, dy = sy - fya;
+    const int xs[4] = {xa, xa + 1, xa, xa + 1};
+    const int ys[4] = {ya, ya, ya + 1, ya + 1};
+    const float pesos[4] = {(1 - dx) * (1 - dy), dx * (1 - dy), (1 - dx) * dy, dx * dy};
+
+    float alfa = 0, color[3] = {0, 0, 0};
+    for (int k = 0; k < 4; ++k) {
+        if (xs[k] < fx0 || xs[k] >= fx1 || ys[k] < fy0 || ys[k] >= fy1 || pesos[k] == 0) continue;
+        const T* p = image + (static_cast<size_t>(ys[k] - fy0) * ancho + (xs[k] - fx0)) * channels;
+        float pesoAlfa = pesos[k] * (alfaFuente ? p[channels - 1] : RasgosMuestra<T>::MAXIMO);
+        alfa += pesoAlfa;
+        for (int c = 0; c < canalesColor; ++c) color[c] += pesoAlfa * p[c];
+    }
+    for (int c = 0; c < canalesColor; ++c) {
+        px[c] = alfa > 0 ? RasgosMuestra<T>::convertir(RasgosMuestra<T>::acotar(color[c] / alfa)) : 0;
+    }
+    px[canalesColor] = RasgosMuestra<T>::convertir(alfa);
+}
+
+// Igual que transformarRegion, pero 'destino' tiene canalesConAlfa(channels) canales
+template <typename T>
+void transformarRegionAlfa(const T* image, const Rectangulo& regionFuente, int channels,
+                           const MatrizAfin& inversa, T* destino, const Rectangulo& regionDestino,
+                           int bloqueAncho, int bloqueAlto, size_t pasoDestino) {
+    const float ia = static_cast<float>(inversa.a), ib = static_cast<float>(inversa.b), ic = static_cast<float>(inversa.c);
+    const float id = static_cast<float>(inversa.d), ie = static_cast<float>(inversa.e), iff = static_cast<float>(inversa.f);
+    const int fx0 = regionFuente.x, fy0 = regionFuente.y;
+    const int fx1 = fx0 + regionFuente.width, fy1 = fy0 + regionFuente.height;
+    const int anchoFuente = regionFuente.width;
+    const int canalesSalida = canalesConAlfa(channels);
+    // Con alfa en la fuente todo el tramo necesita el muestreo premultiplicado
+    const bool interiorOpaco = canalesSalida != channels;
+    if (pasoDestino == 0) pasoDestino = static_cast<size_t>(regionDestino.width) * canalesSalida * sizeof(T);
+
+    Planificador::global().paraCada2D(regionDestino.width, regionDestino.height, bloqueAncho, bloqueAlto,
+                                      [&](int x0, int y0, int x1, int y1) {
+        const int ox = regionDestino.x;
+        const int gx0 = x0 + ox, gx1 = x1 + ox;
+        for (int y = y0; y < y1; ++y) {
+            T* fila = reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(destino) + static_cast<size_t>(y) * pasoDestino);
+            int gy = y + regionDestino.y;
+            float baseX = ib * gy + ic;
+            float baseY = ie * gy + iff;
+            int inicio, fin, inicioInterior = 0, finInterior = 0;
+            tramoValido<BordeAlfa>(ia, id, baseX, baseY, fx0, fy0, fx1, fy1, gx0, gx1, inicio, fin);
+            if (interiorOpaco && inicio < fin) {
+                tramoValido<InteriorAlfa>(ia, id, baseX, baseY, fx0, fy0, fx1, fy1, inicio, fin,
+                                          inicioInterior, finInterior);
+            }
+            if (inicioInterior == finInterior) inicioInterior = finInterior = fin;
+
+            auto pixel = [&](int gx) { return fila + static_cast<size_t>(gx - ox) * canalesSalida; };
+            std::memset(pixel(gx0), 0, static_cast<size_t>(inicio - gx0) * canalesSalida * sizeof(T));
+            for (int gx = inicio; gx < inicioInterior; ++gx) {
+                muestrearBordeAlfa(image, fx0, fy0, fx1, fy1, anchoFuente, channels,
+                                   ia * gx + baseX, id * gx + baseY, pixel(gx));
+            }
+            for (int gx = inicioInterior; gx < finInterior; ++gx) {
+                T* px = pixel(gx);
+                InterpolacionBilineal::muestrearDentro<false>(image, fx0, fy0, fx1, fy1, anchoFuente, channels,
+                                                              ia * gx + baseX, id * gx + baseY, px);
+                px[channels] = RasgosMuestra<T>::convertir(RasgosMuestra<T>::MAXIMO);
+            }
+            for (int gx = finInterior; gx < fin; ++gx) {
+                muestrearBordeAlfa(image, fx0, fy0, fx1, fy1, anchoFuente, channels,
+                                   ia * gx + baseX, id * gx + baseY, pixel(gx));
+            }
+            std::memset(pixel(fin), 0, static_cast<size_t>(gx1 - fin) * canalesSalida * sizeof(T));
+        }
+    });
+}
+
+// Imagen completa sobre un destino ya reservado, por franjas de filas. Con
+// ModoFondo::Alfa el destino tiene canalesConAlfa(channels) canales y el muestreo
+// es siempre bilineal.
+template <typename Interpolador, typename T>
+bool transformarImagenEn(const T* image, int width, int height, int channels, const MatrizAfin& inversa,
+                         T* destino, int newWidth, int newHeight, size_t pasoDestino,
+                         const FondoTransformacion& fondo = FondoTransformacion()) {
+    if (!image || width <= 0 || height <= 0 || channels <= 0 || channels > 4) {
+        std::cerr << "Error: Parámetros inválidos para la transformación\n";
+        return false;
+    }
+    if (newWidth <= 0 || newHeight <= 0) {
+        std::cerr << "Error: Tamaño calculado inválido para la transformación\n";
+        return false;
+    }
+    const bool conAlfa = fondo.modo == ModoFondo::Alfa;
+    size_t bytesFila = static_cast<size_t>(newWidth) * (conAlfa ? canalesConAlfa(channels) : channels) * sizeof(T);
+    if (!destino || (pasoDestino != 0 && pasoDestino < bytesFila)) {
+        std::cerr << "Error: Destino inválido para la transformación (paso " << pasoDestino
+                  << ", se necesitan al menos " << bytesFila << " bytes por fila)\n";
+        return false;
+    }
+
+    Rectangulo fuente, region;
+    fuente.width = width;
+    fuente.height = height;
+    region.width = newWidth;
+    region.height = newHeight;
+    if (conAlfa) {
+        transformarRegionAlfa(image, fuente, channels, inversa, destino, region, newWidth, granoFilas(bytesFila),
+                              pasoDestino);
+    } else {
+        transformarRegion<Interpolador>(image, fuente, channels, inversa, destino, region,
+                                        newWidth, granoFilas(bytesFila), pasoDestino, fondo);
+    }
+    return true;
+}
+
+// Imagen completa: reserva la salida con el asignador y la calcula por franjas de
+// filas. Con muestras de mas de un byte el resultado se libera con el asignador
+// como bytes (reinterpret_cast<unsigned char*>).
+template <typename Interpolador, typename T>
+T* transformarImagen(const T* image, int width, int height, int channels,
+                                 const MatrizAfin& inversa, int newWidth, int newHeight, AsignadorImagen& asignador,
+                                 const FondoTransformacion& fondo = FondoTransformacion()) {
+    if (!image || width <= 0 || height <= 0 || channels <= 0 || channels > 4) {
+        std::cerr << "Error: Parámetros inválidos para la transformación\n";
+        return nullptr;
+    }
+    int canalesSalida = fondo.modo == ModoFondo::Alfa ? canalesConAlfa(channels) : channels;
+    size_t requiredSize = static_cast<size_t>(newWidth) * newHeight * canalesSalida * sizeof(T);
+    if (newWidth <= 0 || newHeight <= 0) {
+        std::cerr << "Error: Tamaño calculado inválido para la transformación\n";
+        return nullptr;
+    }
+    T* salida = reinterpret_cast<T*>(asignador.asignar(requiredSize));
+    if (!salida) {
+        std::cerr << "Error: No se pudo asignar memoria para la imagen (" << requiredSize << " bytes requeridos)\n";
+        return nullptr;
+    }
+    transformarImagenEn<Interpolador>(image, width, height, channels, inversa, salida, newWidth, newHeight, 0, fondo);
+    return salida;
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PLANIFICADOR_H
+#define PLANIFICADOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Tarea = std::function<void()>;
+
+// Planificador global con robo de trabajo: cada hilo tiene su propia cola,
+// toma tareas del final de la suya y, si esta vacia, roba del principio de
+// las demas. Todos los kernels (rotacion, escalado, codificador PNG) envian
+// su trabajo aqui para no crear hilos propios y evitar la sobresuscripcion.
+class Planificador {
+private:
+    struct ColaTrabajador {
+        std::mutex mutex;
+        std::deque<Tarea> tareas;
+    };
+
+    std::vector<std::unique_ptr<ColaTrabajador>> colas;
+    ColaTrabajador inyeccion;   // Tareas enviadas desde hilos externos
+    std::vector<std::thread> trabajadores;
+    std::atomic<int> pendientes;
+    std::atomic<bool> detener;
+    std::mutex mutexSueno;
+    std::condition_variable despertar;
+
+    bool tomarTarea(int indice, Tarea& tarea);
+    void bucleTrabajador(int indice, bool fijarNucleo);
+
+public:
+    // hilos = 0 usa todos los nucleos; el hilo que espera tambien ejecuta tareas
+    explicit Planificador(int hilos = 0, bool fijarNucleos = false);
+    ~Planificador();
+    Planificador(const Planificador&) = delete;
+    Planificador& operator=(const Planificador&) = delete;
+
+    static Planificador& global();
+    // Reemplaza el planificador global (no llamar con tareas en curso)
+    static void configurar(int hilos, bool fijarNucleos);
+
+    int numHilos() const { return static_cast<int>(trabajadores.size()) + 1; }
+    void ejecutar(Tarea tarea);
+    // Ejecuta una tarea pendiente en el hilo actual; false si no habia ninguna
+    bool ejecutarUna();
+
+    // Divide [inicio, fin) en trozos de 'grano' elementos y espera a que terminen
+    void paraCada(int inicio, int fin, int grano, const std::function<void(int, int)>& cuerpo);
+    // Recorre un rango 2-D por bloques de bloqueAncho x bloqueAlto
+    void paraCada2D(int ancho, int alto, int bloqueAncho, int bloqueAlto,
+                    const std::function<void(int x0, int y0, int x1, int y1)>& cuerpo);
+};
+
+// Filas por tarea para que cada una escriba alrededor de 64 KB
+inline int granoFilas(size_t bytesFila) {
+    size_t filas = (64 * 1024) / (bytesFila > 0 ? bytesFila : 1);
+    return filas > 0 ? static_cast<int>(filas) : 1;
+}
+
+// Conjunto de tareas que se espera en bloque. Mientras espera, el hilo ayuda
+// ejecutando tareas pendientes, por lo que se puede anidar sin bloqueos.
+class GrupoTareas {
+private:
+    Planificador& planificador;
+    std::atomic<int> pendientes;
+    std::mutex mutexError;
+    std::exception_ptr error;
+
+public:
+    explicit GrupoTareas(Planificador& planificador = Planificador::global());
+    ~GrupoTareas();
+
+    void ejecutar(Tarea tarea);
+    void esperar();
+};
+
+#endif
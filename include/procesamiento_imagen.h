@@ -1,20 +1,93 @@
-#ifndef PROCESAMIENTO_IMAGEN_H
-#define PROCESAMIENTO_IMAGEN_H
-
-#include "buddy_system.h"
-#include <string>
-
-unsigned char* cargarImagen(const char* filename, int& width, int& height, int& channels);
-
-// Con BuddySystem
-unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, BuddySystem& buddy, int& newWidth, int& newHeight);
-unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, BuddySystem& buddy, int& newWidth, int& newHeight);
-
-// Sin BuddySystem
-unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, int& newWidth, int& newHeight);
-unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, int& newWidth, int& newHeight);
-
-bool guardarImagen(const char* filename, unsigned char* image, int width, int height, int channels);
-unsigned char bilinearInterpolation(float x, float y, unsigned char* img, int width, int height, int channels, int channel);
-
-#endif
+#ifndef PROCESAMIENTO_IMAGEN_H
+#define PROCESAMIENTO_IMAGEN_H
+
+#include "buddy_system.h"
+#include "asignadores.h"
+#include "formatos_imagen.h"
+#include "transformacion_afin.h"
+#include <string>
+
+unsigned char* cargarImagen(const char* filename, int& width, int& height, int& channels);
+
+// Tipo de muestra con el que conviene decodificar un archivo sin perder precision
+enum class ProfundidadMuestra {
+    Bits8,
+    Bits16,     // PNG y PNM de 16 bits
+    Flotante    // HDR (Radiance)
+};
+ProfundidadMuestra profundidadImagen(const char* filename);
+// Como cargarImagen, con 16 bits por canal (stbi_load_16) o en float (stbi_loadf,
+// que pasa las imagenes de 8 y 16 bits a luz lineal con gamma 2.2). Se liberan
+// con stbi_image_free.
+uint16_t* cargarImagen16(const char* filename, int& width, int& height, int& channels);
+float* cargarImagenFlotante(const char* filename, int& width, int& height, int& channels);
+// Devuelve (con new[]) solo el rectangulo pedido. Los PPM/PGM binarios se leen
+// directamente de la proyeccion del archivo sin decodificar el resto; los demas
+// formatos se decodifican completos y se recortan.
+unsigned char* cargarRegionImagen(const char* filename, int x, int y, int regionWidth, int regionHeight,
+                                  int& width, int& height, int& channels);
+
+void calcularNuevoTamano(int width, int height, float angle, int& newWidth, int& newHeight);
+void calcularTamanoEscalado(int width, int height, float scaleFactor, int& newWidth, int& newHeight);
+
+// Con cualquier estrategia de memoria: el resultado se libera con el mismo asignador.
+// 'fondo' decide el valor de las esquinas que la rotacion deja fuera de la imagen;
+// con ModoFondo::Alfa el resultado tiene canalesConFondo(channels, fondo) canales.
+// Con Interpolacion::BilinealLineal el promedio se hace en luz lineal (el borde
+// suavizado de ModoFondo::Alfa se calcula siempre en sRGB).
+unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, AsignadorImagen& asignador, int& newWidth, int& newHeight,
+                           const FondoTransformacion& fondo = FondoTransformacion(),
+                           Interpolacion interpolacion = Interpolacion::Bilineal);
+unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, AsignadorImagen& asignador, int& newWidth, int& newHeight,
+                             Interpolacion interpolacion = Interpolacion::Bilineal);
+
+// Muestras de 16 bits y float, con el mismo motor. El resultado se libera con
+// asignador.liberar(reinterpret_cast<unsigned char*>(resultado)). En float las
+// muestras ya son lineales, asi que BilinealLineal equivale a Bilineal.
+uint16_t* rotarImagen(const uint16_t* image, int width, int height, int channels, float angle, AsignadorImagen& asignador,
+                      int& newWidth, int& newHeight, const FondoTransformacion& fondo = FondoTransformacion(),
+                      Interpolacion interpolacion = Interpolacion::Bilineal);
+float* rotarImagen(const float* image, int width, int height, int channels, float angle, AsignadorImagen& asignador,
+                   int& newWidth, int& newHeight, const FondoTransformacion& fondo = FondoTransformacion(),
+                   Interpolacion interpolacion = Interpolacion::Bilineal);
+uint16_t* escalarImagen(const uint16_t* image, int width, int height, int channels, float scaleFactor,
+                        AsignadorImagen& asignador, int& newWidth, int& newHeight,
+                        Interpolacion interpolacion = Interpolacion::Bilineal);
+float* escalarImagen(const float* image, int width, int height, int channels, float scaleFactor,
+                     AsignadorImagen& asignador, int& newWidth, int& newHeight,
+                     Interpolacion interpolacion = Interpolacion::Bilineal);
+
+// Sobre un destino de quien llama (buffer reutilizado, rectangulo dentro de una
+// imagen mayor, archivo proyectado): no reservan memoria. newWidth x newHeight
+// deben ser los de calcularNuevoTamano / calcularTamanoEscalado y pasoDestino son
+// los bytes entre filas del destino (0 = filas contiguas).
+bool rotarImagenEn(const unsigned char* image, int width, int height, int channels, float angle,
+                   unsigned char* destino, int newWidth, int newHeight, size_t pasoDestino = 0,
+                   const FondoTransformacion& fondo = FondoTransformacion(),
+                   Interpolacion interpolacion = Interpolacion::Bilineal);
+bool escalarImagenEn(const unsigned char* image, int width, int height, int channels, float scaleFactor,
+                     unsigned char* destino, int newWidth, int newHeight, size_t pasoDestino = 0,
+                     Interpolacion interpolacion = Interpolacion::Bilineal);
+
+// Transformaciones exactas en sitio: solo intercambian pixeles, sin interpolar
+// ni reservar memoria. paso son los bytes entre filas (0 = filas contiguas).
+bool voltearHorizontal(unsigned char* image, int width, int height, int channels, size_t paso = 0);
+bool voltearVertical(unsigned char* image, int width, int height, int channels, size_t paso = 0);
+bool rotar180(unsigned char* image, int width, int height, int channels, size_t paso = 0);
+
+// Con BuddySystem
+unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, BuddySystem& buddy, int& newWidth, int& newHeight);
+unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, BuddySystem& buddy, int& newWidth, int& newHeight);
+
+// Sin BuddySystem
+unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, int& newWidth, int& newHeight);
+unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, int& newWidth, int& newHeight);
+
+bool guardarImagen(const char* filename, unsigned char* image, int width, int height, int channels);
+bool guardarImagen(const char* filename, unsigned char* image, int width, int height, int channels, const OpcionesGuardado& opciones);
+// PNG conserva los 16 bits; ver guardarImagenFormato16 y guardarImagenFormatoFlotante
+bool guardarImagen(const char* filename, const uint16_t* image, int width, int height, int channels, const OpcionesGuardado& opciones);
+bool guardarImagen(const char* filename, const float* image, int width, int height, int channels, const OpcionesGuardado& opciones);
+unsigned char bilinearInterpolation(float x, float y, unsigned char* img, int width, int height, int channels, int channel);
+
+#endif
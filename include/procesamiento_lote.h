@@ -0,0 +1,49 @@
+#ifndef PROCESAMIENTO_LOTE_H
+#define PROCESAMIENTO_LOTE_H
+
+#include "formatos_imagen.h"
+#include "cache_resultados.h"
+#include "transformacion_afin.h"
+#include <string>
+#include <vector>
+
+struct OpcionesLote {
+    float angle = 0.0f;
+    float scaleFactor = 1.0f;
+    FondoTransformacion fondo;   // Esquinas que la rotacion deja fuera de la imagen
+    Interpolacion interpolacion = Interpolacion::Bilineal;
+    bool usarBuddy = false;
+    size_t memoriaBuddy = 20 * 1024 * 1024;
+    // Sin Buddy System, los buffers rotados y escalados se reciclan entre imagenes
+    // con un PoolBuffers de hasta limitePool bytes (0 = new[]/delete[] por imagen)
+    size_t limitePool = 256 * 1024 * 1024;
+    int inactividadPoolMs = 2000;   // Los buffers sin uso por mas tiempo se devuelven al sistema
+    // Marcadores: {nombre} (sin extension), {ext}, {dir} y {indice}
+    std::string plantilla = "{nombre}_salida.png";
+    OpcionesGuardado salida;
+
+    // Tuberia: decodificacion, transformacion y codificacion en etapas paralelas
+    bool tuberia = false;
+    int hilosDecodificacion = 1;
+    int hilosTransformacion = 1;
+    int hilosCodificacion = 1;
+    size_t capacidadCola = 2;   // Imagenes en espera entre etapas (limita la memoria en vuelo)
+
+    // Si se indica, las entradas ya procesadas con los mismos parametros se copian
+    // desde la cache sin decodificarlas
+    CacheResultados* cache = nullptr;
+};
+
+// Acepta un directorio, un patron glob o un archivo de manifiesto (una ruta por linea)
+std::vector<std::string> listarEntradasLote(const std::string& origen);
+std::string aplicarPlantilla(const std::string& plantilla, const std::string& entrada, size_t indice);
+
+// Procesa todas las entradas en el mismo proceso, reutilizando el Buddy System.
+// Devuelve la cantidad de imagenes que fallaron.
+int procesarLote(const std::vector<std::string>& entradas, const OpcionesLote& opciones);
+
+// Igual que procesarLote, pero mientras una imagen se codifica la siguiente se
+// transforma y otra se decodifica. Las etapas se comunican con colas acotadas.
+int procesarLoteEnTuberia(const std::vector<std::string>& entradas, const OpcionesLote& opciones);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef TRANSFORMACION_AFIN_H
+#define TRANSFORMACION_AFIN_H
+
+enum class Interpolacion {
+    Vecino,     // Vecino mas cercano
+    Bilineal,
+    BilinealLineal   // Bilineal promediando en luz lineal en vez de sRGB
+};
+
+// Acepta vecino, bilineal o lineal
+bool interpolacionDesdeTexto(const char* texto, Interpolacion& interpolacion);
+
+// Valor de los pixeles de la salida que caen fuera de la fuente
+enum class ModoFondo {
+    Transparente,    // Todos los canales en 0 (negro si la imagen no tiene alfa)
+    Constante,       // Un color fijo
+    ExtenderBorde,   // Repite el pixel del borde mas cercano
+    Repetir,         // La fuente se repite como un mosaico
+    Alfa             // Se agrega canal alfa: 0 fuera de la fuente y borde suavizado
+};
+
+struct FondoTransformacion {
+    ModoFondo modo = ModoFondo::Transparente;
+    unsigned char color[4] = {0, 0, 0, 255};   // RGBA, solo para Constante
+};
+
+// Acepta transparente, extender, repetir, alfa o un color R,G,B[,A]
+bool fondoDesdeTexto(const char* texto, FondoTransformacion& fondo);
+// Canales que produce una rotacion con este fondo (Alfa agrega alfa a gris y RGB)
+int canalesConFondo(int channels, const FondoTransformacion& fondo);
+// Bytes del fondo constante para una imagen de 'channels' canales (gris, gris+alfa, RGB o RGBA)
+void colorFondoPara(const FondoTransformacion& fondo, int channels, unsigned char* px);
+
+// x' = a*x + b*y + c ; y' = d*x + e*y + f
+struct MatrizAfin {
+    double a = 1, b = 0, c = 0;
+    double d = 0, e = 1, f = 0;
+
+    static MatrizAfin identidad() { return MatrizAfin(); }
+    static MatrizAfin traslacion(double tx, double ty);
+    static MatrizAfin escala(double sx, double sy);
+    // Rotacion directa tal como la define rotarImagen (angulo en grados)
+    static MatrizAfin rotacion(double grados);
+
+    // Primero se aplica 'primero' y despues *this
+    MatrizAfin componer(const MatrizAfin& primero) const;
+    MatrizAfin inversa() const;
+    bool esIdentidad(double tolerancia = 1e-9) const;
+};
+
+struct Rectangulo {
+    int x = 0, y = 0, width = 0, height = 0;
+
+    bool vacio() const { return width <= 0 || height <= 0; }
+    Rectangulo interseccion(const Rectangulo& otro) const;
+};
+
+// Geometria de rotarImagen y escalarImagen: tamano de salida y matriz directa
+// (rotacion alrededor del centro; escala con tamano redondeado)
+MatrizAfin matrizRotacionImagen(int width, int height, float angle, int& newWidth, int& newHeight);
+MatrizAfin matrizEscalaImagen(int width, int height, float scaleFactor, int& newWidth, int& newHeight);
+
+// Rectangulo minimo de la fuente (width x height) que hace falta leer para
+// calcular 'destino' con la transformacion inversa dada, incluido el vecino
+// extra de la interpolacion bilineal
+Rectangulo proyectarRectangulo(const MatrizAfin& inversa, const Rectangulo& destino, int width, int height);
+
+// Calcula cada pixel de destino muestreando la fuente en inversa*(x, y).
+// Los pixeles que caen fuera de la fuente quedan en 0. El trabajo se reparte
+// en bloques de bloqueAncho x bloqueAlto en el planificador global.
+void aplicarTransformacionAfin(const unsigned char* image, int width, int height, int channels,
+                               const MatrizAfin& inversa, unsigned char* destino, int newWidth, int newHeight,
+                               Interpolacion interpolacion, int bloqueAncho, int bloqueAlto);
+
+// Variante por regiones: 'image' contiene solo regionFuente de la fuente y
+// 'destino' recibe solo regionDestino de la salida (ambas en coordenadas globales)
+void aplicarTransformacionAfin(const unsigned char* image, const Rectangulo& regionFuente, int channels,
+                               const MatrizAfin& inversa, unsigned char* destino, const Rectangulo& regionDestino,
+                               Interpolacion interpolacion, int bloqueAncho, int bloqueAlto);
+
+#endif
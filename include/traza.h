@@ -0,0 +1,44 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <atomic>
+#include <cstdint>
+
+// Trazas por tramos en formato Chrome trace (chrome://tracing, Perfetto).
+// Cada hilo escribe en su propio buffer sin bloqueos; con la traza apagada
+// un tramo cuesta una lectura atomica y un salto.
+extern std::atomic<bool> trazaHabilitada;
+
+void iniciarTraza();
+// Escribe todos los eventos; llamar cuando no haya tramos en curso
+bool guardarTraza(const char* filename);
+// Nombre visible del hilo actual en el visor
+void nombrarHiloTraza(const char* nombre);
+
+uint64_t relojTrazaNs();
+void registrarTramo(const char* nombre, const char* categoria, uint64_t inicioNs, uint64_t finNs);
+
+class TramoTraza {
+private:
+    const char* nombre;
+    const char* categoria;
+    uint64_t inicio;
+
+public:
+    // nombre y categoria deben ser literales (se guarda el puntero)
+    explicit TramoTraza(const char* nombre, const char* categoria = "app")
+        : nombre(nombre), categoria(categoria),
+          inicio(trazaHabilitada.load(std::memory_order_relaxed) ? relojTrazaNs() : 0) {}
+    ~TramoTraza() {
+        if (inicio != 0) registrarTramo(nombre, categoria, inicio, relojTrazaNs());
+    }
+    TramoTraza(const TramoTraza&) = delete;
+    TramoTraza& operator=(const TramoTraza&) = delete;
+};
+
+#define TRAZA_CONCATENAR_(a, b) a##b
+#define TRAZA_CONCATENAR(a, b) TRAZA_CONCATENAR_(a, b)
+// Mide desde este punto hasta el final del bloque
+#define TRAZA_TRAMO(...) TramoTraza TRAZA_CONCATENAR(tramoTraza_, __LINE__)(__VA_ARGS__)
+
+#endif
@@ -0,0 +1,42 @@
+#include "archivo_mapeado.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+ArchivoMapeado::ArchivoMapeado() : datos(nullptr), longitud(0) {}
+
+ArchivoMapeado::~ArchivoMapeado() {
+    cerrar();
+}
+
+bool ArchivoMapeado::abrir(const char* filename, bool secuencial) {
+    cerrar();
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // La proyeccion sigue valida despues de cerrar el descriptor
+    if (p == MAP_FAILED) return false;
+
+    if (secuencial) {
+        madvise(p, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    }
+    datos = p;
+    longitud = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void ArchivoMapeado::cerrar() {
+    if (datos) {
+        munmap(datos, longitud);
+        datos = nullptr;
+        longitud = 0;
+    }
+}
@@ -0,0 +1,281 @@
+#include "asignadores.h"
+#include "traza.h"
+#include <iostream>
+#include <new>
+
+namespace {
+
+const size_t ALINEACION = 64;   // Una linea de cache
+// Cabecera delante de cada buffer del pool con su clase de tamano
+const size_t CABECERA_POOL = ALINEACION;
+
+size_t alinear(size_t n) {
+    return (n + ALINEACION - 1) / ALINEACION * ALINEACION;
+}
+
+unsigned char* reservarAlineado(size_t n) {
+    return static_cast<unsigned char*>(::operator new[](n, std::align_val_t(ALINEACION), std::nothrow));
+}
+
+void liberarAlineado(unsigned char* p) {
+    ::operator delete[](p, std::align_val_t(ALINEACION));
+}
+
+} // namespace
+
+unsigned char* AsignadorHeap::asignar(size_t n) {
+    return new (std::nothrow) unsigned char[n];
+}
+
+void AsignadorHeap::liberar(unsigned char* p) {
+    delete[] p;
+}
+
+unsigned char* AsignadorBuddy::asignar(size_t n) {
+    return static_cast<unsigned char*>(buddy.allocate(n));
+}
+
+void AsignadorBuddy::liberar(unsigned char* p) {
+    buddy.free(p);
+}
+
+AsignadorArena::AsignadorArena(size_t capacidad)
+    : bloque(reservarAlineado(alinear(capacidad))), capacidad(bloque ? alinear(capacidad) : 0), usado(0), pico(0) {
+    if (!bloque) {
+        std::cerr << "Error: No se pudo reservar la arena de " << capacidad << " bytes\n";
+    }
+}
+
+AsignadorArena::~AsignadorArena() {
+    if (bloque) liberarAlineado(bloque);
+}
+
+unsigned char* AsignadorArena::asignar(size_t n) {
+    size_t tamano = alinear(n);
+    if (tamano > capacidad - usado) {
+        std::cerr << "Error: La arena no tiene espacio para " << n << " bytes (" << capacidad - usado << " libres)\n";
+        return nullptr;
+    }
+    unsigned char* p = bloque + usado;
+    inicios.push_back(usado);
+    usado += tamano;
+    if (usado > pico) pico = usado;
+    return p;
+}
+
+void AsignadorArena::liberar(unsigned char* p) {
+    if (!p || inicios.empty()) return;
+    // Solo la ultima asignacion se puede devolver; las demas esperan a reiniciar()
+    if (p == bloque + inicios.back()) {
+        usado = inicios.back();
+        inicios.pop_back();
+    }
+}
+
+void AsignadorArena::reiniciar() {
+    usado = 0;
+    inicios.clear();
+}
+
+AsignadorPoolHilo::AsignadorPoolHilo() : maximoPorClase(4) {}
+
+AsignadorPoolHilo::~AsignadorPoolHilo() {
+    vaciar();
+}
+
+AsignadorPoolHilo& AsignadorPoolHilo::delHilo() {
+    thread_local AsignadorPoolHilo pool;
+    return pool;
+}
+
+unsigned char* AsignadorPoolHilo::asignar(size_t n) {
+    TRAZA_TRAMO("pool_asignar", "memoria");
+    int clase = 0;
+    while ((static_cast<size_t>(1) << clase) < n && clase < NUM_CLASES - 1) ++clase;
+
+    unsigned char* base;
+    if (!libres[clase].empty()) {
+        base = libres[clase].back();
+        libres[clase].pop_back();
+    } else {
+        base = reservarAlineado(CABECERA_POOL + (static_cast<size_t>(1) << clase));
+        if (!base) return nullptr;
+        *reinterpret_cast<int*>(base) = clase;
+    }
+    return base + CABECERA_POOL;
+}
+
+void AsignadorPoolHilo::liberar(unsigned char* p) {
+    if (!p) return;
+    unsigned char* base = p - CABECERA_POOL;
+    int clase = *reinterpret_cast<int*>(base);
+    if (libres[clase].size() < maximoPorClase) {
+        libres[clase].push_back(base);
+    } else {
+        liberarAlineado(base);
+    }
+}
+
+void AsignadorPoolHilo::vaciar() {
+    for (auto& lista : libres) {
+        for (unsigned char* base : lista) liberarAlineado(base);
+        lista.clear();
+    }
+}
+
+namespace {
+
+const int BITS_MINIMO_COMPARTIDO = 12;   // Clase mas chica: 4 KB
+
+// Clase de un pedido de n bytes y tamano real del buffer: 4 KB o bien
+// 2^e * {5,6,7,8}/4 con 2^e < n
+int claseCompartida(size_t n, size_t& tamano) {
+    if (n <= (static_cast<size_t>(1) << BITS_MINIMO_COMPARTIDO)) {
+        tamano = static_cast<size_t>(1) << BITS_MINIMO_COMPARTIDO;
+        return 0;
+    }
+    int e = 63 - __builtin_clzll(static_cast<unsigned long long>(n - 1));
+    size_t paso = static_cast<size_t>(1) << (e - 2);
+    size_t cuartos = (n + paso - 1) / paso;   // 5..8
+    tamano = cuartos * paso;
+    return 1 + (e - BITS_MINIMO_COMPARTIDO) * 4 + static_cast<int>(cuartos - 5);
+}
+
+size_t tamanoDeClase(int clase) {
+    if (clase == 0) return static_cast<size_t>(1) << BITS_MINIMO_COMPARTIDO;
+    int e = (clase - 1) / 4 + BITS_MINIMO_COMPARTIDO;
+    size_t cuartos = static_cast<size_t>((clase - 1) % 4 + 5);
+    return cuartos << (e - 2);
+}
+
+} // namespace
+
+PoolBuffers::PoolBuffers(size_t limite, std::chrono::milliseconds inactividad)
+    : limite(limite), inactividad(inactividad), ultimaRevision(std::chrono::steady_clock::now()),
+      bytesGuardados(0), picoGuardados(0), aciertos(0), fallos(0), recortados(0) {}
+
+PoolBuffers::~PoolBuffers() {
+    vaciar();
+}
+
+// Libera el buffer mas viejo guardado en la clase (requiere el mutex tomado)
+void PoolBuffers::descartar(int clase) {
+    liberarAlineado(libres[clase].front().base);
+    libres[clase].pop_front();
+    bytesGuardados -= tamanoDeClase(clase);
+    ++recortados;
+}
+
+void PoolBuffers::recortarInactivos(std::chrono::steady_clock::time_point ahora) {
+    // La revision completa se hace como mucho cuatro veces por periodo de inactividad
+    if (ahora - ultimaRevision < inactividad / 4) return;
+    ultimaRevision = ahora;
+    for (int clase = 0; clase < NUM_CLASES; ++clase) {
+        while (!libres[clase].empty() && ahora - libres[clase].front().liberado >= inactividad) {
+            descartar(clase);
+        }
+    }
+}
+
+unsigned char* PoolBuffers::asignar(size_t n) {
+    TRAZA_TRAMO("pool_compartido_asignar", "memoria");
+    size_t tamano;
+    int clase = claseCompartida(n, tamano);
+    if (clase >= NUM_CLASES) return nullptr;
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        recortarInactivos(std::chrono::steady_clock::now());
+        if (!libres[clase].empty()) {
+            // El liberado mas reciente es el que tiene mas probabilidad de seguir en cache
+            unsigned char* base = libres[clase].back().base;
+            libres[clase].pop_back();
+            bytesGuardados -= tamano;
+            ++aciertos;
+            return base + CABECERA_POOL;
+        }
+        ++fallos;
+    }
+    unsigned char* base = reservarAlineado(CABECERA_POOL + tamano);
+    if (!base) return nullptr;
+    *reinterpret_cast<int*>(base) = clase;
+    return base + CABECERA_POOL;
+}
+
+void PoolBuffers::liberar(unsigned char* p) {
+    if (!p) return;
+    unsigned char* base = p - CABECERA_POOL;
+    int clase = *reinterpret_cast<int*>(base);
+    size_t tamano = tamanoDeClase(clase);
+    auto ahora = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    recortarInactivos(ahora);
+    if (tamano > limite) {
+        liberarAlineado(base);
+        ++recortados;
+        return;
+    }
+    // Se hace lugar descartando los buffers guardados hace mas tiempo
+    while (bytesGuardados + tamano > limite) {
+        int masViejo = -1;
+        for (int c = 0; c < NUM_CLASES; ++c) {
+            if (!libres[c].empty() && (masViejo < 0 || libres[c].front().liberado < libres[masViejo].front().liberado)) {
+                masViejo = c;
+            }
+        }
+        descartar(masViejo);
+    }
+    libres[clase].push_back(Libre{base, ahora});
+    bytesGuardados += tamano;
+    if (bytesGuardados > picoGuardados) picoGuardados = bytesGuardados;
+}
+
+void PoolBuffers::vaciar() {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    for (auto& lista : libres) {
+        for (const Libre& libre : lista) liberarAlineado(libre.base);
+        lista.clear();
+    }
+    bytesGuardados = 0;
+}
+
+size_t PoolBuffers::numAciertos() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return aciertos;
+}
+
+size_t PoolBuffers::numFallos() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return fallos;
+}
+
+size_t PoolBuffers::numRecortados() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return recortados;
+}
+
+size_t PoolBuffers::memoriaGuardada() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return bytesGuardados;
+}
+
+size_t PoolBuffers::picoMemoria() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return picoGuardados;
+}
+
+AsignadorExterno::AsignadorExterno(unsigned char* buffer, size_t capacidad)
+    : buffer(buffer), capacidad(capacidad), ocupado(false) {}
+
+unsigned char* AsignadorExterno::asignar(size_t n) {
+    if (ocupado || !buffer || n > capacidad) {
+        std::cerr << "Error: El buffer externo no alcanza (" << n << " bytes pedidos, " << capacidad << " disponibles)\n";
+        return nullptr;
+    }
+    ocupado = true;
+    return buffer;
+}
+
+void AsignadorExterno::liberar(unsigned char* p) {
+    if (p == buffer) ocupado = false;
+}
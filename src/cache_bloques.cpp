@@ -0,0 +1,122 @@
+#include "cache_bloques.h"
+#include "hash_contenido.h"
+#include <algorithm>
+#include <cstring>
+
+size_t HashClaveBloque::operator()(const ClaveBloque& c) const {
+    uint64_t h = combinarHash(c.origen, c.transformacion);
+    h = combinarHash(h, (static_cast<uint64_t>(static_cast<uint32_t>(c.bx)) << 32) | static_cast<uint32_t>(c.by));
+    return static_cast<size_t>(h);
+}
+
+CacheBloques::CacheBloques(size_t presupuestoBytes) : presupuesto(presupuestoBytes) {}
+
+void CacheBloques::desalojarHasta(size_t limite) {
+    while (stats.bytesUsados > limite && !lru.empty()) {
+        const Entrada& ultima = lru.back();
+        stats.bytesUsados -= ultima.second->pixeles.size();
+        indice.erase(ultima.first);
+        lru.pop_back();
+        ++stats.desalojos;
+    }
+    stats.bloques = lru.size();
+}
+
+std::shared_ptr<const BufferImagen> CacheBloques::buscar(const ClaveBloque& clave) {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    auto it = indice.find(clave);
+    if (it == indice.end()) {
+        ++stats.fallos;
+        return nullptr;
+    }
+    ++stats.aciertos;
+    lru.splice(lru.begin(), lru, it->second);   // Pasa a ser el mas reciente
+    return it->second->second;
+}
+
+void CacheBloques::insertar(const ClaveBloque& clave, std::shared_ptr<const BufferImagen> bloque) {
+    if (!bloque || bloque->pixeles.size() > presupuesto) return;
+
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    auto it = indice.find(clave);
+    if (it != indice.end()) {
+        stats.bytesUsados -= it->second->second->pixeles.size();
+        lru.erase(it->second);
+        indice.erase(it);
+    }
+    desalojarHasta(presupuesto - bloque->pixeles.size());
+    lru.emplace_front(clave, bloque);
+    indice[clave] = lru.begin();
+    stats.bytesUsados += bloque->pixeles.size();
+    stats.bloques = lru.size();
+}
+
+std::shared_ptr<const BufferImagen> CacheBloques::obtenerBloque(const GrafoOperaciones& grafo, const std::vector<EtapaPlan>& plan,
+                                                                uint64_t huellaPlan, int bx, int by) {
+    ClaveBloque clave{grafo.huellaOrigen(), huellaPlan, bx, by};
+    std::shared_ptr<const BufferImagen> bloque = buscar(clave);
+    if (bloque) return bloque;
+
+    std::shared_ptr<BufferImagen> nuevo = std::make_shared<BufferImagen>();
+    if (!grafo.ejecutarBloque(plan, bx, by, *nuevo)) return nullptr;
+    insertar(clave, nuevo);
+    return nuevo;
+}
+
+bool CacheBloques::renderizarRegion(const GrafoOperaciones& grafo, const Rectangulo& region, BufferImagen& resultado) {
+    std::vector<EtapaPlan> plan;
+    int eliminadas = 0;
+    if (!grafo.planificar(plan, eliminadas)) return false;
+    int w, h, ch;
+    if (plan.empty()) {
+        if (!grafo.tamanoSalida(w, h, ch)) return false;
+    } else {
+        w = plan.back().width;
+        h = plan.back().height;
+        ch = plan.back().channels;
+    }
+    uint64_t huellaPlan = grafo.huellaTransformacion(plan);
+    Rectangulo completo;
+    completo.width = w;
+    completo.height = h;
+    Rectangulo pedido = region.interseccion(completo);
+    if (pedido.vacio()) return false;
+
+    resultado.width = pedido.width;
+    resultado.height = pedido.height;
+    resultado.channels = ch;
+    resultado.pixeles.assign(static_cast<size_t>(pedido.width) * pedido.height * ch, 0);
+
+    int bx0 = pedido.x / TAMANO_BLOQUE_REGION, bx1 = (pedido.x + pedido.width - 1) / TAMANO_BLOQUE_REGION;
+    int by0 = pedido.y / TAMANO_BLOQUE_REGION, by1 = (pedido.y + pedido.height - 1) / TAMANO_BLOQUE_REGION;
+    for (int by = by0; by <= by1; ++by) {
+        for (int bx = bx0; bx <= bx1; ++bx) {
+            std::shared_ptr<const BufferImagen> bloque = obtenerBloque(grafo, plan, huellaPlan, bx, by);
+            if (!bloque) return false;
+
+            // Copiar la parte del bloque que cae dentro de la region
+            Rectangulo rectBloque = grafo.rectanguloBloque(bx, by).interseccion(completo);
+            Rectangulo comun = rectBloque.interseccion(pedido);
+            size_t bytes = static_cast<size_t>(comun.width) * ch;
+            for (int y = comun.y; y < comun.y + comun.height; ++y) {
+                std::memcpy(resultado.pixeles.data() + (static_cast<size_t>(y - pedido.y) * pedido.width + (comun.x - pedido.x)) * ch,
+                            bloque->pixeles.data() + (static_cast<size_t>(y - rectBloque.y) * rectBloque.width + (comun.x - rectBloque.x)) * ch,
+                            bytes);
+            }
+        }
+    }
+    return true;
+}
+
+void CacheBloques::limpiar() {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    lru.clear();
+    indice.clear();
+    stats.bytesUsados = 0;
+    stats.bloques = 0;
+}
+
+EstadisticasCache CacheBloques::estadisticas() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return stats;
+}
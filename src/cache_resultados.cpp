@@ -0,0 +1,146 @@
+#include "cache_resultados.h"
+#include "archivo_mapeado.h"
+#include "hash_contenido.h"
+#include "motor_transformacion.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Version del formato de clave; la de los kernels (VERSION_KERNELS) va aparte en la clave
+const char* VERSION_CACHE = "2";
+
+std::atomic<unsigned> contadorTemporales(0);
+
+std::string nombreTemporal(const std::string& destino) {
+    return destino + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(contadorTemporales++);
+}
+
+// Escribe una copia de origen en destino mediante un temporal y rename()
+bool copiarAtomico(const std::string& origen, const std::string& destino) {
+    ArchivoMapeado archivo;
+    if (!archivo.abrir(origen.c_str())) return false;
+
+    std::string temporal = nombreTemporal(destino);
+    FILE* salida = fopen(temporal.c_str(), "wb");
+    if (!salida) return false;
+    bool ok = fwrite(archivo.data(), 1, archivo.size(), salida) == archivo.size();
+    ok = (fclose(salida) == 0) && ok;
+    if (!ok || rename(temporal.c_str(), destino.c_str()) != 0) {
+        remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CacheResultados::CacheResultados(const std::string& directorio, size_t limiteBytes)
+    : directorio(directorio), limiteBytes(limiteBytes), bytesUsados(0), aciertos(0), fallos(0) {}
+
+std::string CacheResultados::rutaEntrada(const std::string& clave) const {
+    return directorio + "/" + clave;
+}
+
+bool CacheResultados::preparar() {
+    if (mkdir(directorio.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "Error: No se pudo crear el directorio de cache " << directorio << "\n";
+        return false;
+    }
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    bytesUsados = limiteBytes + 1;   // Fuerza una medicion completa
+    recortar();
+    return true;
+}
+
+std::string CacheResultados::huellaEntrada(const std::string& entrada) {
+    ArchivoMapeado archivo;
+    if (!archivo.abrir(entrada.c_str())) return "";
+    return huellaHexadecimal(archivo.data(), archivo.size());
+}
+
+std::string CacheResultados::calcularClave(const std::string& huella, const std::string& parametros) {
+    if (huella.empty()) return "";
+    std::string texto = huella + "|" + VERSION_CACHE + "." + std::to_string(VERSION_KERNELS) + "|" + parametros;
+    return huellaHexadecimal(texto.data(), texto.size());
+}
+
+bool CacheResultados::recuperar(const std::string& clave, const std::string& destino) {
+    std::string ruta = rutaEntrada(clave);
+    if (clave.empty() || !copiarAtomico(ruta, destino)) {
+        ++fallos;
+        return false;
+    }
+    // La fecha de modificacion hace de marca LRU para el recorte
+    utimensat(AT_FDCWD, ruta.c_str(), nullptr, 0);
+    ++aciertos;
+    return true;
+}
+
+bool CacheResultados::almacenar(const std::string& clave, const std::string& origen) {
+    if (clave.empty()) return false;
+    struct stat info;
+    if (stat(origen.c_str(), &info) != 0 || static_cast<size_t>(info.st_size) > limiteBytes) return false;
+    if (!copiarAtomico(origen, rutaEntrada(clave))) return false;
+
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    bytesUsados += static_cast<size_t>(info.st_size);
+    if (bytesUsados > limiteBytes) recortar();
+    return true;
+}
+
+// Mide el directorio y borra las entradas mas antiguas hasta quedar en el 90% del limite.
+// Se llama con el mutex tomado.
+void CacheResultados::recortar() {
+    struct EntradaCache {
+        std::string ruta;
+        size_t bytes;
+        struct timespec modificado;
+    };
+    std::vector<EntradaCache> entradas;
+    bytesUsados = 0;
+
+    DIR* dir = opendir(directorio.c_str());
+    if (!dir) return;
+    while (dirent* e = readdir(dir)) {
+        std::string nombre = e->d_name;
+        if (nombre[0] == '.' || nombre.find(".tmp") != std::string::npos) continue;
+        std::string ruta = rutaEntrada(nombre);
+        struct stat info;
+        if (stat(ruta.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) continue;
+        entradas.push_back({ruta, static_cast<size_t>(info.st_size), info.st_mtim});
+        bytesUsados += static_cast<size_t>(info.st_size);
+    }
+    closedir(dir);
+    if (bytesUsados <= limiteBytes) return;
+
+    std::sort(entradas.begin(), entradas.end(), [](const EntradaCache& a, const EntradaCache& b) {
+        if (a.modificado.tv_sec != b.modificado.tv_sec) return a.modificado.tv_sec < b.modificado.tv_sec;
+        return a.modificado.tv_nsec < b.modificado.tv_nsec;
+    });
+    size_t objetivo = limiteBytes / 10 * 9;
+    for (const EntradaCache& entrada : entradas) {
+        if (bytesUsados <= objetivo) break;
+        if (remove(entrada.ruta.c_str()) == 0) {
+            bytesUsados -= entrada.bytes;
+        }
+    }
+}
+
+std::string parametrosResultado(const char* modo, int bitsMuestra, float angle, float scaleFactor, const FondoTransformacion& fondo,
+                                Interpolacion interpolacion, FormatoImagen formato, const OpcionesGuardado& opciones) {
+    char texto[192];
+    snprintf(texto, sizeof(texto), "%s|%d|%.9g|%.9g|%d:%d,%d,%d,%d|%d|%d|%d|%d|%d", modo, bitsMuestra, angle, scaleFactor,
+             static_cast<int>(fondo.modo), fondo.color[0], fondo.color[1], fondo.color[2], fondo.color[3],
+             static_cast<int>(interpolacion),
+             static_cast<int>(formato), opciones.calidadJPEG,
+             static_cast<int>(opciones.png.nivel), static_cast<int>(opciones.png.filtro));
+    return texto;
+}
@@ -0,0 +1,100 @@
+#include "calidad_imagen.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+const char* nombrePatron(PatronSintetico patron) {
+    switch (patron) {
+        case PatronSintetico::Degradado: return "degradado";
+        case PatronSintetico::Tablero: return "tablero";
+        case PatronSintetico::Ruido: return "ruido";
+        default: return "zonas";
+    }
+}
+
+std::vector<unsigned char> generarImagenSintetica(PatronSintetico patron, int width, int height, int channels,
+                                                  uint32_t semilla) {
+    std::vector<unsigned char> pixeles(static_cast<size_t>(width) * height * channels);
+    // Generador propio (xorshift) para que el resultado no dependa de la biblioteca estandar
+    uint32_t estado = semilla ? semilla : 1;
+    double cx = width / 2.0, cy = height / 2.0;
+    double radioMax = std::sqrt(cx * cx + cy * cy);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char* p = &pixeles[(static_cast<size_t>(y) * width + x) * channels];
+            for (int c = 0; c < channels; ++c) {
+                int valor;
+                switch (patron) {
+                    case PatronSintetico::Degradado:
+                        valor = (c % 2 == 0) ? x * 255 / std::max(1, width - 1) : y * 255 / std::max(1, height - 1);
+                        if (c == 2) valor = 255 - valor;
+                        break;
+                    case PatronSintetico::Tablero:
+                        valor = (((x / 8) + (y / 8) + c) % 2) ? 255 : 0;
+                        break;
+                    case PatronSintetico::Ruido:
+                        estado ^= estado << 13;
+                        estado ^= estado >> 17;
+                        estado ^= estado << 5;
+                        valor = static_cast<int>(estado & 0xFF);
+                        break;
+                    default: {
+                        double r = std::hypot(x - cx, y - cy) / radioMax;
+                        valor = static_cast<int>(127.5 + 127.5 * std::cos(M_PI * r * r * width / 4.0 + c));
+                        break;
+                    }
+                }
+                // El ultimo canal de RGBA / gris+alfa es una rampa de alfa
+                if ((channels == 2 || channels == 4) && c == channels - 1) {
+                    valor = 64 + (x + y) * 191 / std::max(1, width + height - 2);
+                }
+                p[c] = static_cast<unsigned char>(std::min(255, std::max(0, valor)));
+            }
+        }
+    }
+    return pixeles;
+}
+
+MetricasCalidad compararImagenes(const unsigned char* a, const unsigned char* b, int width, int height, int channels) {
+    MetricasCalidad metricas;
+    size_t n = static_cast<size_t>(width) * height * channels;
+    double sumaCuadrados = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        int d = std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
+        metricas.diferenciaMaxima = std::max(metricas.diferenciaMaxima, d);
+        sumaCuadrados += static_cast<double>(d) * d;
+    }
+    double mse = n ? sumaCuadrados / n : 0.0;
+    metricas.psnr = mse > 0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : std::numeric_limits<double>::infinity();
+
+    const double C1 = (0.01 * 255) * (0.01 * 255);
+    const double C2 = (0.03 * 255) * (0.03 * 255);
+    const int ventana = 8, paso = 4;
+    double sumaSSIM = 0.0;
+    int ventanas = 0;
+    for (int c = 0; c < channels; ++c) {
+        for (int y0 = 0; y0 + ventana <= height; y0 += paso) {
+            for (int x0 = 0; x0 + ventana <= width; x0 += paso) {
+                double sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0;
+                for (int y = y0; y < y0 + ventana; ++y) {
+                    for (int x = x0; x < x0 + ventana; ++x) {
+                        size_t i = (static_cast<size_t>(y) * width + x) * channels + c;
+                        double va = a[i], vb = b[i];
+                        sa += va; sb += vb;
+                        saa += va * va; sbb += vb * vb; sab += va * vb;
+                    }
+                }
+                const double m = ventana * ventana;
+                double ma = sa / m, mb = sb / m;
+                double va = saa / m - ma * ma, vb = sbb / m - mb * mb, cov = sab / m - ma * mb;
+                sumaSSIM += ((2 * ma * mb + C1) * (2 * cov + C2)) / ((ma * ma + mb * mb + C1) * (va + vb + C2));
+                ++ventanas;
+            }
+        }
+    }
+    // Imagenes mas chicas que una ventana: se usa solo la diferencia exacta
+    metricas.ssim = ventanas ? sumaSSIM / ventanas : (metricas.diferenciaMaxima == 0 ? 1.0 : 0.0);
+    return metricas;
+}
@@ -0,0 +1,345 @@
+#include "compresion_deflate.h"
+#include <algorithm>
+
+namespace {
+
+const int VENTANA = 32768;
+const int MASCARA_VENTANA = VENTANA - 1;
+const int BITS_HASH = 15;
+const int TAMANO_HASH = 1 << BITS_HASH;
+const int MIN_COINCIDENCIA = 3;
+const int MAX_COINCIDENCIA = 258;
+const int MIN_ANTICIPACION = MAX_COINCIDENCIA + MIN_COINCIDENCIA;
+const int MAX_BLOQUE_ALMACENADO = 65535;
+
+const int BASE_LONGITUD[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                               35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const int EXTRA_LONGITUD[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const int BASE_DISTANCIA[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                8193, 12289, 16385, 24577};
+const int EXTRA_DISTANCIA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Tablas de busqueda inversa: longitud -> codigo y distancia -> codigo
+struct TablasDeflate {
+    unsigned char codigoLongitud[MAX_COINCIDENCIA + 1];
+    unsigned char codigoDistancia[VENTANA + 1];
+    uint32_t crc[256];
+
+    TablasDeflate() {
+        for (int c = 0; c < 29; ++c) {
+            int hasta = (c == 28) ? 258 : BASE_LONGITUD[c] + (1 << EXTRA_LONGITUD[c]) - 1;
+            for (int l = BASE_LONGITUD[c]; l <= hasta && l <= MAX_COINCIDENCIA; ++l) {
+                codigoLongitud[l] = static_cast<unsigned char>(c);
+            }
+        }
+        codigoLongitud[MAX_COINCIDENCIA] = 28;
+        for (int c = 0; c < 30; ++c) {
+            int hasta = BASE_DISTANCIA[c] + (1 << EXTRA_DISTANCIA[c]) - 1;
+            for (int d = BASE_DISTANCIA[c]; d <= hasta && d <= VENTANA; ++d) {
+                codigoDistancia[d] = static_cast<unsigned char>(c);
+            }
+        }
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            crc[n] = c;
+        }
+    }
+};
+
+const TablasDeflate& tablas() {
+    static const TablasDeflate t;
+    return t;
+}
+
+inline uint32_t invertirBits(uint32_t codigo, int n) {
+    uint32_t r = 0;
+    for (int i = 0; i < n; ++i) {
+        r = (r << 1) | (codigo & 1);
+        codigo >>= 1;
+    }
+    return r;
+}
+
+} // namespace
+
+NivelCompresion nivelDesdeEntero(int nivel) {
+    if (nivel <= 0) return NivelCompresion::Almacenar;
+    if (nivel <= 3) return NivelCompresion::Rapido;
+    if (nivel <= 7) return NivelCompresion::Normal;
+    return NivelCompresion::Maximo;
+}
+
+uint32_t calcularAdler32(uint32_t adler, const unsigned char* datos, size_t n) {
+    const uint32_t BASE = 65521;
+    const size_t NMAX = 5552;
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    while (n > 0) {
+        size_t bloque = std::min(n, NMAX);
+        n -= bloque;
+        for (size_t i = 0; i < bloque; ++i) {
+            a += datos[i];
+            b += a;
+        }
+        datos += bloque;
+        a %= BASE;
+        b %= BASE;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t combinarAdler32(uint32_t adler1, uint32_t adler2, size_t longitud2) {
+    const uint32_t BASE = 65521;
+    uint32_t resto = static_cast<uint32_t>(longitud2 % BASE);
+    uint32_t suma1 = adler1 & 0xFFFF;
+    uint32_t suma2 = static_cast<uint32_t>((static_cast<uint64_t>(resto) * suma1) % BASE);
+    suma1 += (adler2 & 0xFFFF) + BASE - 1;
+    suma2 += ((adler1 >> 16) & 0xFFFF) + ((adler2 >> 16) & 0xFFFF) + BASE - resto;
+    if (suma1 >= BASE) suma1 -= BASE;
+    if (suma1 >= BASE) suma1 -= BASE;
+    if (suma2 >= (BASE << 1)) suma2 -= (BASE << 1);
+    if (suma2 >= BASE) suma2 -= BASE;
+    return suma1 | (suma2 << 16);
+}
+
+uint32_t calcularCRC32(uint32_t crc, const unsigned char* datos, size_t n) {
+    const uint32_t* tabla = tablas().crc;
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) {
+        crc = tabla[(crc ^ datos[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+CompresorDeflate::CompresorDeflate(NivelCompresion nivel)
+    : nivel(nivel), base(0), pos(0), insertado(0), bits(0), numBits(0), bloqueAbierto(false) {
+    switch (nivel) {
+        case NivelCompresion::Almacenar:
+            longitudCadena = 0; longitudSuficiente = 0; evaluacionPerezosa = false; break;
+        case NivelCompresion::Rapido:
+            longitudCadena = 4; longitudSuficiente = 16; evaluacionPerezosa = false; break;
+        case NivelCompresion::Normal:
+            longitudCadena = 32; longitudSuficiente = 128; evaluacionPerezosa = false; break;
+        case NivelCompresion::Maximo:
+            longitudCadena = 512; longitudSuficiente = MAX_COINCIDENCIA; evaluacionPerezosa = true; break;
+    }
+    if (nivel != NivelCompresion::Almacenar) {
+        cabeza.assign(TAMANO_HASH, -1);
+        previo.assign(VENTANA, -1);
+    }
+}
+
+void CompresorDeflate::escribirBits(uint32_t valor, int n, std::vector<unsigned char>& salida) {
+    bits |= static_cast<uint64_t>(valor) << numBits;
+    numBits += n;
+    while (numBits >= 8) {
+        salida.push_back(static_cast<unsigned char>(bits & 0xFF));
+        bits >>= 8;
+        numBits -= 8;
+    }
+}
+
+// Los codigos Huffman se empaquetan empezando por el bit mas significativo
+void CompresorDeflate::escribirCodigo(uint32_t codigo, int n, std::vector<unsigned char>& salida) {
+    escribirBits(invertirBits(codigo, n), n, salida);
+}
+
+void CompresorDeflate::alinearByte(std::vector<unsigned char>& salida) {
+    if (numBits > 0) {
+        escribirBits(0, 8 - numBits, salida);
+    }
+}
+
+void CompresorDeflate::escribirLiteral(int simbolo, std::vector<unsigned char>& salida) {
+    if (simbolo < 144) {
+        escribirCodigo(0x30 + simbolo, 8, salida);
+    } else if (simbolo < 256) {
+        escribirCodigo(0x190 + (simbolo - 144), 9, salida);
+    } else if (simbolo < 280) {
+        escribirCodigo(simbolo - 256, 7, salida);
+    } else {
+        escribirCodigo(0xC0 + (simbolo - 280), 8, salida);
+    }
+}
+
+void CompresorDeflate::escribirCoincidencia(int longitud, int distancia, std::vector<unsigned char>& salida) {
+    const TablasDeflate& t = tablas();
+    int cl = t.codigoLongitud[longitud];
+    escribirLiteral(257 + cl, salida);
+    if (EXTRA_LONGITUD[cl] > 0) {
+        escribirBits(longitud - BASE_LONGITUD[cl], EXTRA_LONGITUD[cl], salida);
+    }
+    int cd = t.codigoDistancia[distancia];
+    escribirCodigo(cd, 5, salida);
+    if (EXTRA_DISTANCIA[cd] > 0) {
+        escribirBits(distancia - BASE_DISTANCIA[cd], EXTRA_DISTANCIA[cd], salida);
+    }
+}
+
+void CompresorDeflate::insertarHasta(int64_t limite) {
+    const int64_t f = fin();
+    while (insertado < limite && insertado + 2 < f) {
+        const unsigned char* p = &datos[insertado - base];
+        uint32_t h = ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & (TAMANO_HASH - 1);
+        previo[insertado & MASCARA_VENTANA] = cabeza[h];
+        cabeza[h] = insertado;
+        ++insertado;
+    }
+}
+
+int CompresorDeflate::buscarCoincidencia(int64_t p, int& distancia) {
+    int maxLongitud = static_cast<int>(std::min<int64_t>(MAX_COINCIDENCIA, fin() - p));
+    if (maxLongitud < MIN_COINCIDENCIA) return 0;
+
+    const unsigned char* actual = &datos[p - base];
+    uint32_t h = ((actual[0] << 10) ^ (actual[1] << 5) ^ actual[2]) & (TAMANO_HASH - 1);
+    int64_t limiteInferior = std::max(base, p - VENTANA);
+    int64_t candidato = cabeza[h];
+    int mejor = MIN_COINCIDENCIA - 1;
+
+    for (int intentos = 0; intentos < longitudCadena; ++intentos) {
+        if (candidato < limiteInferior || candidato >= p) break;
+        const unsigned char* previoPtr = &datos[candidato - base];
+        if (previoPtr[mejor] == actual[mejor] && previoPtr[0] == actual[0]) {
+            int l = 0;
+            while (l < maxLongitud && previoPtr[l] == actual[l]) ++l;
+            if (l > mejor) {
+                mejor = l;
+                distancia = static_cast<int>(p - candidato);
+                if (l >= longitudSuficiente || l == maxLongitud) break;
+            }
+        }
+        int64_t siguiente = previo[candidato & MASCARA_VENTANA];
+        if (siguiente >= candidato) break;
+        candidato = siguiente;
+    }
+
+    return mejor >= MIN_COINCIDENCIA ? mejor : 0;
+}
+
+void CompresorDeflate::codificar(int64_t limite, std::vector<unsigned char>& salida) {
+    if (pos >= limite) return;
+    if (!bloqueAbierto) {
+        escribirBits(0, 1, salida);   // BFINAL = 0
+        escribirBits(1, 2, salida);   // BTYPE = 01 (Huffman fijo)
+        bloqueAbierto = true;
+    }
+
+    while (pos < limite) {
+        insertarHasta(pos);
+        int distancia = 0;
+        int longitud = buscarCoincidencia(pos, distancia);
+
+        if (longitud > 0 && evaluacionPerezosa && longitud < longitudSuficiente && pos + 1 < limite) {
+            insertarHasta(pos + 1);
+            int distanciaSiguiente = 0;
+            if (buscarCoincidencia(pos + 1, distanciaSiguiente) > longitud) {
+                longitud = 0;
+            }
+        }
+
+        if (longitud > 0) {
+            escribirCoincidencia(longitud, distancia, salida);
+            pos += longitud;
+        } else {
+            escribirLiteral(datos[pos - base], salida);
+            ++pos;
+        }
+    }
+}
+
+void CompresorDeflate::escribirBloquesAlmacenados(int64_t limite, bool final, std::vector<unsigned char>& salida) {
+    int64_t pendiente = limite - pos;
+    do {
+        int n = static_cast<int>(std::min<int64_t>(pendiente, MAX_BLOQUE_ALMACENADO));
+        bool ultimo = final && n == pendiente;
+        escribirBits(ultimo ? 1 : 0, 1, salida);
+        escribirBits(0, 2, salida);   // BTYPE = 00 (sin comprimir)
+        alinearByte(salida);
+        salida.push_back(static_cast<unsigned char>(n & 0xFF));
+        salida.push_back(static_cast<unsigned char>(n >> 8));
+        salida.push_back(static_cast<unsigned char>(~n & 0xFF));
+        salida.push_back(static_cast<unsigned char>((~n >> 8) & 0xFF));
+        salida.insert(salida.end(), datos.begin() + (pos - base), datos.begin() + (pos - base) + n);
+        pos += n;
+        pendiente -= n;
+    } while (pendiente > 0);
+}
+
+void CompresorDeflate::cerrarBloque(std::vector<unsigned char>& salida) {
+    if (bloqueAbierto) {
+        escribirCodigo(0, 7, salida);   // Fin de bloque (simbolo 256)
+        bloqueAbierto = false;
+    }
+}
+
+void CompresorDeflate::deslizarVentana() {
+    int64_t conservarDesde = (nivel == NivelCompresion::Almacenar) ? pos : pos - VENTANA;
+    if (conservarDesde - base < VENTANA) return;
+    datos.erase(datos.begin(), datos.begin() + (conservarDesde - base));
+    base = conservarDesde;
+    insertado = std::max(insertado, base);
+}
+
+void CompresorDeflate::precargarDiccionario(const unsigned char* dic, size_t n) {
+    if (n > static_cast<size_t>(VENTANA)) {
+        dic += n - VENTANA;
+        n = VENTANA;
+    }
+    datos.insert(datos.end(), dic, dic + n);
+    pos = fin();
+    if (nivel == NivelCompresion::Almacenar) {
+        deslizarVentana();
+    }
+}
+
+void CompresorDeflate::comprimir(const unsigned char* entrada, size_t n, std::vector<unsigned char>& salida) {
+    datos.insert(datos.end(), entrada, entrada + n);
+    if (nivel == NivelCompresion::Almacenar) {
+        // Emitir solo bloques completos; el resto espera mas datos
+        int64_t completos = ((fin() - pos) / MAX_BLOQUE_ALMACENADO) * MAX_BLOQUE_ALMACENADO;
+        if (completos > 0) {
+            escribirBloquesAlmacenados(pos + completos, false, salida);
+        }
+    } else if (fin() - pos > MIN_ANTICIPACION) {
+        codificar(fin() - MIN_ANTICIPACION, salida);
+    }
+    deslizarVentana();
+}
+
+void CompresorDeflate::vaciar(std::vector<unsigned char>& salida) {
+    if (nivel == NivelCompresion::Almacenar) {
+        escribirBloquesAlmacenados(fin(), false, salida);
+    } else {
+        codificar(fin(), salida);
+        cerrarBloque(salida);
+        // Bloque almacenado vacio: alinea la salida a byte (como Z_SYNC_FLUSH)
+        escribirBits(0, 3, salida);
+        alinearByte(salida);
+        salida.push_back(0x00);
+        salida.push_back(0x00);
+        salida.push_back(0xFF);
+        salida.push_back(0xFF);
+    }
+    deslizarVentana();
+}
+
+void CompresorDeflate::finalizar(std::vector<unsigned char>& salida) {
+    if (nivel == NivelCompresion::Almacenar) {
+        escribirBloquesAlmacenados(fin(), true, salida);
+    } else {
+        codificar(fin(), salida);
+        cerrarBloque(salida);
+        escribirBits(1, 1, salida);      // BFINAL = 1
+        escribirBits(1, 2, salida);      // Huffman fijo
+        escribirCodigo(0, 7, salida);    // Bloque vacio
+        alinearByte(salida);
+    }
+    deslizarVentana();
+}
@@ -0,0 +1,180 @@
+#include "contadores_hardware.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const char* NOMBRES_EVENTOS[NUM_EVENTOS_HARDWARE] = {
+    "ciclos", "instrucciones", "fallos LLC", "fallos dTLB", "fallos de salto"
+};
+
+void configurarEvento(EventoHardware evento, perf_event_attr& attr) {
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    switch (evento) {
+        case EVENTO_CICLOS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case EVENTO_INSTRUCCIONES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case EVENTO_FALLOS_LLC:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case EVENTO_FALLOS_DTLB:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        default:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+    // Solo espacio de usuario: funciona con perf_event_paranoid <= 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+
+int abrirEvento(perf_event_attr& attr, pid_t tid) {
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+std::vector<pid_t> hilosDelProceso() {
+    std::vector<pid_t> hilos;
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) {
+        hilos.push_back(static_cast<pid_t>(syscall(SYS_gettid)));
+        return hilos;
+    }
+    while (dirent* e = readdir(dir)) {
+        if (e->d_name[0] != '.') hilos.push_back(static_cast<pid_t>(std::atoi(e->d_name)));
+    }
+    closedir(dir);
+    return hilos;
+}
+
+} // namespace
+
+ContadoresHardware::ContadoresHardware() {
+    for (bool& d : disponibles) d = false;
+}
+
+ContadoresHardware::~ContadoresHardware() {
+    for (auto& lista : descriptores) {
+        for (int fd : lista) close(fd);
+    }
+}
+
+bool ContadoresHardware::abrir() {
+    std::vector<pid_t> hilos = hilosDelProceso();
+    int errorApertura = 0;
+    for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+        perf_event_attr attr;
+        configurarEvento(static_cast<EventoHardware>(e), attr);
+        bool completo = true;
+        for (pid_t tid : hilos) {
+            int fd = abrirEvento(attr, tid);
+            if (fd < 0) {
+                errorApertura = errno;
+                completo = false;
+                break;
+            }
+            descriptores[e].push_back(fd);
+        }
+        // Un evento vale solo si se pudo abrir en todos los hilos
+        if (!completo) {
+            for (int fd : descriptores[e]) close(fd);
+            descriptores[e].clear();
+        }
+        disponibles[e] = completo;
+    }
+
+    if (!disponible()) {
+        error = std::string("perf_event_open no disponible (") + std::strerror(errorApertura) + ")";
+        if (errorApertura == EACCES || errorApertura == EPERM) {
+            error += "; revise /proc/sys/kernel/perf_event_paranoid";
+        }
+        return false;
+    }
+    for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+        if (!disponibles[e]) {
+            std::cerr << "[CONTADORES] Evento no soportado: " << NOMBRES_EVENTOS[e] << "\n";
+        }
+    }
+    return true;
+}
+
+bool ContadoresHardware::disponible() const {
+    return disponibles[EVENTO_CICLOS] || disponibles[EVENTO_INSTRUCCIONES];
+}
+
+LecturaContadores ContadoresHardware::leer() const {
+    LecturaContadores lectura;
+    for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+        if (!disponibles[e]) continue;
+        double total = 0.0;
+        bool ok = true;
+        for (int fd : descriptores[e]) {
+            uint64_t datos[3];   // valor, tiempo habilitado, tiempo en ejecucion
+            if (read(fd, datos, sizeof(datos)) != static_cast<ssize_t>(sizeof(datos))) {
+                ok = false;
+                break;
+            }
+            // Si el kernel multiplexo el contador se extrapola al tiempo total
+            total += (datos[2] > 0 && datos[2] < datos[1])
+                         ? static_cast<double>(datos[0]) * datos[1] / datos[2]
+                         : static_cast<double>(datos[0]);
+        }
+        lectura.valores[e] = static_cast<uint64_t>(total);
+        lectura.validos[e] = ok;
+    }
+    return lectura;
+}
+
+LecturaContadores diferenciaContadores(const LecturaContadores& fin, const LecturaContadores& inicio) {
+    LecturaContadores delta;
+    for (int e = 0; e < NUM_EVENTOS_HARDWARE; ++e) {
+        delta.validos[e] = fin.validos[e] && inicio.validos[e];
+        delta.valores[e] = delta.validos[e] && fin.valores[e] > inicio.valores[e] ? fin.valores[e] - inicio.valores[e] : 0;
+    }
+    return delta;
+}
+
+MedidorContadores::MedidorContadores(const ContadoresHardware* contadores, const std::string& nombre)
+    : contadores(contadores && contadores->disponible() ? contadores : nullptr), nombre(nombre) {
+    if (this->contadores) inicio = this->contadores->leer();
+}
+
+void MedidorContadores::terminar() {
+    if (!contadores) return;
+    LecturaContadores d = diferenciaContadores(contadores->leer(), inicio);
+
+    std::cout << "[CONTADORES] " << nombre;
+    if (d.validos[EVENTO_CICLOS]) std::cout << " | Ciclos: " << d.valores[EVENTO_CICLOS];
+    if (d.validos[EVENTO_INSTRUCCIONES]) std::cout << " | Instrucciones: " << d.valores[EVENTO_INSTRUCCIONES];
+    if (d.validos[EVENTO_CICLOS] && d.validos[EVENTO_INSTRUCCIONES] && d.valores[EVENTO_CICLOS] > 0) {
+        std::cout << " | IPC: " << static_cast<double>(d.valores[EVENTO_INSTRUCCIONES]) / d.valores[EVENTO_CICLOS];
+    }
+    // Fallos por cada mil instrucciones (MPKI)
+    double kiloInstrucciones = d.validos[EVENTO_INSTRUCCIONES] ? d.valores[EVENTO_INSTRUCCIONES] / 1000.0 : 0.0;
+    for (int e = EVENTO_FALLOS_LLC; e < NUM_EVENTOS_HARDWARE; ++e) {
+        if (!d.validos[e]) continue;
+        std::cout << " | " << NOMBRES_EVENTOS[e] << ": " << d.valores[e];
+        if (kiloInstrucciones > 0) std::cout << " (" << d.valores[e] / kiloInstrucciones << "/kinstr)";
+    }
+    std::cout << "\n";
+}
@@ -0,0 +1,375 @@
+#include "escritura_png.h"
+#include "planificador.h"
+#include "traza.h"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+
+const size_t TAMANO_IDAT = 64 * 1024;
+const size_t TAMANO_BLOQUE_PARALELO = 256 * 1024;
+const size_t TAMANO_DICCIONARIO = 32 * 1024;
+
+inline unsigned char paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return static_cast<unsigned char>(a);
+    if (pb <= pc) return static_cast<unsigned char>(b);
+    return static_cast<unsigned char>(c);
+}
+
+inline unsigned char predecir(FiltroPNG filtro, int a, int b, int c) {
+    switch (filtro) {
+        case FiltroPNG::Sub: return static_cast<unsigned char>(a);
+        case FiltroPNG::Arriba: return static_cast<unsigned char>(b);
+        case FiltroPNG::Promedio: return static_cast<unsigned char>((a + b) >> 1);
+        case FiltroPNG::Paeth: return paeth(a, b, c);
+        default: return 0;
+    }
+}
+
+void escribirEnteroBE(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v >> 24);
+    p[1] = static_cast<unsigned char>(v >> 16);
+    p[2] = static_cast<unsigned char>(v >> 8);
+    p[3] = static_cast<unsigned char>(v);
+}
+
+bool escribirBloquePNG(FILE* archivo, const char* tipo, const unsigned char* datos, size_t n) {
+    unsigned char cabecera[8];
+    escribirEnteroBE(cabecera, static_cast<uint32_t>(n));
+    std::memcpy(cabecera + 4, tipo, 4);
+    uint32_t crc = calcularCRC32(0, cabecera + 4, 4);
+    crc = calcularCRC32(crc, datos, n);
+    unsigned char cola[4];
+    escribirEnteroBE(cola, crc);
+
+    return fwrite(cabecera, 1, 8, archivo) == 8 &&
+           (n == 0 || fwrite(datos, 1, n, archivo) == n) &&
+           fwrite(cola, 1, 4, archivo) == 4;
+}
+
+bool escribirCabeceraPNG(FILE* archivo, int width, int height, int channels, int bitsMuestra) {
+    static const unsigned char firma[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    static const unsigned char tiposColor[5] = {0, 0, 4, 2, 6};
+    unsigned char ihdr[13];
+    escribirEnteroBE(ihdr, static_cast<uint32_t>(width));
+    escribirEnteroBE(ihdr + 4, static_cast<uint32_t>(height));
+    ihdr[8] = static_cast<unsigned char>(bitsMuestra);   // Profundidad de bits (8 o 16)
+    ihdr[9] = tiposColor[channels];  // Gris, gris+alfa, RGB o RGBA
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+    return fwrite(firma, 1, 8, archivo) == 8 && escribirBloquePNG(archivo, "IHDR", ihdr, sizeof(ihdr));
+}
+
+// Cabecera zlib: ventana de 32 KB y nivel indicado en FLEVEL
+void escribirCabeceraZlib(NivelCompresion nivel, std::vector<unsigned char>& salida) {
+    salida.push_back(0x78);
+    switch (nivel) {
+        case NivelCompresion::Almacenar: salida.push_back(0x01); break;
+        case NivelCompresion::Rapido: salida.push_back(0x5E); break;
+        case NivelCompresion::Normal: salida.push_back(0x9C); break;
+        case NivelCompresion::Maximo: salida.push_back(0xDA); break;
+    }
+}
+
+} // namespace
+
+bool filtroDesdeTexto(const char* texto, FiltroPNG& filtro) {
+    static const struct { const char* nombre; FiltroPNG filtro; } nombres[] = {
+        {"ninguno", FiltroPNG::Ninguno}, {"sub", FiltroPNG::Sub}, {"arriba", FiltroPNG::Arriba},
+        {"promedio", FiltroPNG::Promedio}, {"paeth", FiltroPNG::Paeth}, {"adaptativo", FiltroPNG::Adaptativo},
+    };
+    for (const auto& n : nombres) {
+        if (std::strcmp(texto, n.nombre) == 0) {
+            filtro = n.filtro;
+            return true;
+        }
+    }
+    return false;
+}
+
+FiltroPNG elegirFiltroPNG(const unsigned char* fila, const unsigned char* anterior, size_t bytesFila, int bpp) {
+    // Heuristica estandar: minimizar la suma de los residuos vistos como bytes con signo
+    static const FiltroPNG candidatos[] = {FiltroPNG::Ninguno, FiltroPNG::Sub, FiltroPNG::Arriba,
+                                           FiltroPNG::Promedio, FiltroPNG::Paeth};
+    FiltroPNG mejor = FiltroPNG::Ninguno;
+    long mejorSuma = -1;
+    for (FiltroPNG f : candidatos) {
+        long suma = 0;
+        for (size_t i = 0; i < bytesFila; ++i) {
+            int a = i >= static_cast<size_t>(bpp) ? fila[i - bpp] : 0;
+            int b = anterior ? anterior[i] : 0;
+            int c = (anterior && i >= static_cast<size_t>(bpp)) ? anterior[i - bpp] : 0;
+            unsigned char r = static_cast<unsigned char>(fila[i] - predecir(f, a, b, c));
+            suma += std::abs(static_cast<signed char>(r));
+        }
+        if (mejorSuma < 0 || suma < mejorSuma) {
+            mejorSuma = suma;
+            mejor = f;
+        }
+    }
+    return mejor;
+}
+
+void filtrarFilaPNG(const unsigned char* fila, const unsigned char* anterior, size_t bytesFila,
+                    int bpp, FiltroPNG filtro, unsigned char* salida) {
+    if (filtro == FiltroPNG::Adaptativo) {
+        filtro = elegirFiltroPNG(fila, anterior, bytesFila, bpp);
+    }
+    salida[0] = static_cast<unsigned char>(filtro);
+    unsigned char* destino = salida + 1;
+
+    if (filtro == FiltroPNG::Ninguno) {
+        std::memcpy(destino, fila, bytesFila);
+        return;
+    }
+    for (size_t i = 0; i < bytesFila; ++i) {
+        int a = i >= static_cast<size_t>(bpp) ? fila[i - bpp] : 0;
+        int b = anterior ? anterior[i] : 0;
+        int c = (anterior && i >= static_cast<size_t>(bpp)) ? anterior[i - bpp] : 0;
+        destino[i] = static_cast<unsigned char>(fila[i] - predecir(filtro, a, b, c));
+    }
+}
+
+EscritorPNG::EscritorPNG()
+    : archivo(nullptr), width(0), height(0), channels(0), bytesPixel(0), filasEscritas(0),
+      compresor(NivelCompresion::Almacenar), adler(1) {}
+
+EscritorPNG::~EscritorPNG() {
+    if (archivo) {
+        fclose(archivo);
+    }
+}
+
+bool EscritorPNG::escribirBloque(const char* tipo, const unsigned char* datos, size_t n) {
+    return escribirBloquePNG(archivo, tipo, datos, n);
+}
+
+bool EscritorPNG::volcarIDAT(bool forzar) {
+    if (comprimido.empty() || (!forzar && comprimido.size() < TAMANO_IDAT)) {
+        return true;
+    }
+    bool ok = escribirBloque("IDAT", comprimido.data(), comprimido.size());
+    comprimido.clear();
+    return ok;
+}
+
+bool EscritorPNG::abrir(const char* filename, int width, int height, int channels, const OpcionesPNG& opciones,
+                        int bitsMuestra) {
+    if (width <= 0 || height <= 0 || channels < 1 || channels > 4 || (bitsMuestra != 8 && bitsMuestra != 16)) {
+        std::cerr << "Error: Parámetros inválidos para PNG\n";
+        return false;
+    }
+    archivo = fopen(filename, "wb");
+    if (!archivo) {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escritura\n";
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+    this->channels = channels;
+    this->bytesPixel = channels * bitsMuestra / 8;
+    this->opciones = opciones;
+    filasEscritas = 0;
+    adler = 1;
+    compresor = CompresorDeflate(opciones.nivel);
+
+    size_t bytesFila = static_cast<size_t>(width) * bytesPixel;
+    filaAnterior.assign(bytesFila, 0);
+    filtrada.assign(bytesFila + 1, 0);
+    comprimido.clear();
+    comprimido.reserve(TAMANO_IDAT + bytesFila);
+
+    if (!escribirCabeceraPNG(archivo, width, height, channels, bitsMuestra)) {
+        std::cerr << "Error al escribir la cabecera PNG\n";
+        return false;
+    }
+
+    escribirCabeceraZlib(opciones.nivel, comprimido);
+    return true;
+}
+
+bool EscritorPNG::escribirFila(const unsigned char* fila) {
+    if (!archivo || filasEscritas >= height) {
+        std::cerr << "Error: Fila PNG fuera de rango\n";
+        return false;
+    }
+    size_t bytesFila = static_cast<size_t>(width) * bytesPixel;
+
+    // Sin compresion el filtro no aporta nada: se omite para ir mas rapido
+    FiltroPNG filtro = opciones.nivel == NivelCompresion::Almacenar ? FiltroPNG::Ninguno : opciones.filtro;
+    filtrarFilaPNG(fila, filasEscritas > 0 ? filaAnterior.data() : nullptr, bytesFila, bytesPixel, filtro, filtrada.data());
+    std::memcpy(filaAnterior.data(), fila, bytesFila);
+
+    adler = calcularAdler32(adler, filtrada.data(), filtrada.size());
+    compresor.comprimir(filtrada.data(), filtrada.size(), comprimido);
+    ++filasEscritas;
+    return volcarIDAT(false);
+}
+
+bool EscritorPNG::cerrar() {
+    if (!archivo) return false;
+    bool ok = filasEscritas == height;
+    if (!ok) {
+        std::cerr << "Error: PNG incompleto (" << filasEscritas << " de " << height << " filas)\n";
+    }
+
+    compresor.finalizar(comprimido);
+    unsigned char cola[4];
+    escribirEnteroBE(cola, adler);
+    comprimido.insert(comprimido.end(), cola, cola + 4);
+
+    ok = ok && volcarIDAT(true) && escribirBloque("IEND", nullptr, 0);
+    ok = (fclose(archivo) == 0) && ok;
+    archivo = nullptr;
+    return ok;
+}
+
+namespace {
+
+struct BloquePNG {
+    int filaInicio, filaFin;
+    std::vector<unsigned char> comprimido;
+    uint32_t adler;
+    size_t bytesFiltrados;
+};
+
+void filtrarFilas(const unsigned char* image, size_t bytesFila, int bpp, FiltroPNG filtro,
+                  int filaInicio, int filaFin, std::vector<unsigned char>& salida) {
+    salida.resize(static_cast<size_t>(filaFin - filaInicio) * (bytesFila + 1));
+    for (int y = filaInicio; y < filaFin; ++y) {
+        const unsigned char* anterior = y > 0 ? image + (y - 1) * bytesFila : nullptr;
+        filtrarFilaPNG(image + y * bytesFila, anterior, bytesFila, bpp, filtro,
+                       salida.data() + (y - filaInicio) * (bytesFila + 1));
+    }
+}
+
+void comprimirBloque(const unsigned char* image, size_t bytesFila, int bpp, const OpcionesPNG& opciones,
+                     int filasDiccionario, bool ultimo, BloquePNG& bloque) {
+    TRAZA_TRAMO("png_bloque", "codificacion");
+    FiltroPNG filtro = opciones.nivel == NivelCompresion::Almacenar ? FiltroPNG::Ninguno : opciones.filtro;
+    CompresorDeflate compresor(opciones.nivel);
+
+    // El filtrado es determinista, asi que el diccionario se recalcula en vez de esperar al bloque previo
+    std::vector<unsigned char> filtrado;
+    int inicioDiccionario = std::max(0, bloque.filaInicio - filasDiccionario);
+    if (inicioDiccionario < bloque.filaInicio) {
+        filtrarFilas(image, bytesFila, bpp, filtro, inicioDiccionario, bloque.filaInicio, filtrado);
+        compresor.precargarDiccionario(filtrado.data(), filtrado.size());
+    }
+
+    filtrarFilas(image, bytesFila, bpp, filtro, bloque.filaInicio, bloque.filaFin, filtrado);
+    bloque.bytesFiltrados = filtrado.size();
+    bloque.adler = calcularAdler32(1, filtrado.data(), filtrado.size());
+    compresor.comprimir(filtrado.data(), filtrado.size(), bloque.comprimido);
+    if (ultimo) {
+        compresor.finalizar(bloque.comprimido);
+    } else {
+        compresor.vaciar(bloque.comprimido);
+    }
+}
+
+} // namespace
+
+bool guardarImagenPNGParalelo(const char* filename, const unsigned char* image, int width, int height, int channels,
+                              const OpcionesPNG& opciones, int hilos, int bitsMuestra) {
+    if (!image || width <= 0 || height <= 0 || channels < 1 || channels > 4 || (bitsMuestra != 8 && bitsMuestra != 16)) {
+        std::cerr << "Error: Parámetros inválidos para PNG\n";
+        return false;
+    }
+
+    const int bpp = channels * bitsMuestra / 8;
+    size_t bytesFila = static_cast<size_t>(width) * bpp;
+    int filasPorBloque = static_cast<int>(std::max<size_t>(1, TAMANO_BLOQUE_PARALELO / (bytesFila + 1)));
+    int filasDiccionario = static_cast<int>((TAMANO_DICCIONARIO + bytesFila) / (bytesFila + 1));
+
+    std::vector<BloquePNG> bloques;
+    for (int y = 0; y < height; y += filasPorBloque) {
+        bloques.push_back({y, std::min(height, y + filasPorBloque), {}, 1, 0});
+    }
+
+    // Los bloques se reparten en el planificador global, agrupados en unas 'hilos' tareas
+    int numBloques = static_cast<int>(bloques.size());
+    int porTarea = std::max(1, numBloques / std::max(1, hilos));
+    Planificador::global().paraCada(0, numBloques, porTarea, [&](int b0, int b1) {
+        for (int i = b0; i < b1; ++i) {
+            comprimirBloque(image, bytesFila, bpp, opciones, filasDiccionario, i + 1 == numBloques, bloques[i]);
+        }
+    });
+
+    FILE* archivo = fopen(filename, "wb");
+    if (!archivo) {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escritura\n";
+        return false;
+    }
+    bool ok = escribirCabeceraPNG(archivo, width, height, channels, bitsMuestra);
+
+    std::vector<unsigned char> cabeceraZlib;
+    escribirCabeceraZlib(opciones.nivel, cabeceraZlib);
+    ok = ok && escribirBloquePNG(archivo, "IDAT", cabeceraZlib.data(), cabeceraZlib.size());
+
+    uint32_t adler = 1;
+    for (const BloquePNG& bloque : bloques) {
+        adler = combinarAdler32(adler, bloque.adler, bloque.bytesFiltrados);
+        ok = ok && escribirBloquePNG(archivo, "IDAT", bloque.comprimido.data(), bloque.comprimido.size());
+    }
+    unsigned char cola[4];
+    escribirEnteroBE(cola, adler);
+    ok = ok && escribirBloquePNG(archivo, "IDAT", cola, 4);
+    ok = ok && escribirBloquePNG(archivo, "IEND", nullptr, 0);
+    ok = (fclose(archivo) == 0) && ok;
+    return ok;
+}
+
+namespace {
+
+// 'datos' ya esta en el orden del PNG (muestras de 16 bits en big-endian)
+bool guardarDatosPNG(const char* filename, const unsigned char* datos, int width, int height, int channels,
+                     int bitsMuestra, const OpcionesPNG& opciones) {
+    int hilos = opciones.hilos > 0 ? opciones.hilos : Planificador::global().numHilos();
+    size_t bytesFila = static_cast<size_t>(width) * channels * bitsMuestra / 8;
+    if (hilos > 1 && bytesFila * height > 2 * TAMANO_BLOQUE_PARALELO) {
+        return guardarImagenPNGParalelo(filename, datos, width, height, channels, opciones, hilos, bitsMuestra);
+    }
+
+    EscritorPNG escritor;
+    if (!escritor.abrir(filename, width, height, channels, opciones, bitsMuestra)) {
+        return false;
+    }
+    for (int y = 0; y < height; ++y) {
+        if (!escritor.escribirFila(datos + y * bytesFila)) {
+            return false;
+        }
+    }
+    return escritor.cerrar();
+}
+
+} // namespace
+
+bool guardarImagenPNG(const char* filename, const unsigned char* image, int width, int height, int channels,
+                      const OpcionesPNG& opciones) {
+    return guardarDatosPNG(filename, image, width, height, channels, 8, opciones);
+}
+
+bool guardarImagenPNG16(const char* filename, const uint16_t* image, int width, int height, int channels,
+                        const OpcionesPNG& opciones) {
+    if (!image || width <= 0 || height <= 0 || channels < 1 || channels > 4) {
+        std::cerr << "Error: Parámetros inválidos para PNG\n";
+        return false;
+    }
+    // PNG guarda las muestras de 16 bits en big-endian
+    size_t muestras = static_cast<size_t>(width) * height * channels;
+    std::vector<unsigned char> datos(muestras * 2);
+    for (size_t i = 0; i < muestras; ++i) {
+        datos[2 * i] = static_cast<unsigned char>(image[i] >> 8);
+        datos[2 * i + 1] = static_cast<unsigned char>(image[i]);
+    }
+    return guardarDatosPNG(filename, datos.data(), width, height, channels, 16, opciones);
+}
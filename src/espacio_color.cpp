@@ -0,0 +1,33 @@
+#include "espacio_color.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+double srgbALinealDoble(double c) {
+    return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+double linealASrgbDoble(double l) {
+    return l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1 / 2.4) - 0.055;
+}
+
+} // namespace
+
+float srgbALineal(float c) {
+    return static_cast<float>(srgbALinealDoble(c));
+}
+
+float linealASrgb(float l) {
+    return static_cast<float>(linealASrgbDoble(l));
+}
+
+TablasColor::TablasColor() {
+    for (int v = 0; v < 256; ++v) {
+        aLineal[v] = static_cast<uint16_t>(std::lround(srgbALinealDoble(v / 255.0) * 65535.0));
+    }
+    for (int i = 0; i <= 4096; ++i) {
+        double c = linealASrgbDoble(std::min(1.0, i * 16 / 65535.0));
+        aSrgb[i] = static_cast<uint8_t>(std::min(255L, std::max(0L, std::lround(c * 255.0))));
+    }
+}
@@ -0,0 +1,279 @@
+#include "formatos_imagen.h"
+#include "stb_image_write.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+const struct { const char* nombre; FormatoImagen formato; } NOMBRES_FORMATO[] = {
+    {"png", FormatoImagen::PNG}, {"jpg", FormatoImagen::JPEG}, {"jpeg", FormatoImagen::JPEG},
+    {"bmp", FormatoImagen::BMP}, {"tga", FormatoImagen::TGA}, {"ppm", FormatoImagen::PNM},
+    {"pgm", FormatoImagen::PNM}, {"pnm", FormatoImagen::PNM}, {"qoi", FormatoImagen::QOI},
+    {"hdr", FormatoImagen::HDR},
+};
+
+// Gamma con la que stbi_loadf pasa las imagenes de 8 y 16 bits a float
+const float GAMMA_FLOTANTE = 2.2f;
+
+// El alfa (ultimo canal de gris+alfa y RGBA) es lineal y no lleva gamma
+inline bool esCanalAlfa(size_t i, int channels) {
+    return (channels == 2 || channels == 4) && i % channels == static_cast<size_t>(channels - 1);
+}
+
+// Muestras enteras de 0..maximo a float en luz lineal
+template <typename T>
+std::vector<float> aFlotante(const T* image, size_t muestras, int channels, float maximo) {
+    std::vector<float> salida(muestras);
+    for (size_t i = 0; i < muestras; ++i) {
+        float v = image[i] / maximo;
+        salida[i] = esCanalAlfa(i, channels) ? v : std::pow(v, GAMMA_FLOTANTE);
+    }
+    return salida;
+}
+
+// Escritura con buffer propio para no hacer una llamada a fwrite por pixel
+class SalidaBuffer {
+private:
+    FILE* archivo;
+    std::vector<unsigned char> buffer;
+    bool ok;
+
+public:
+    explicit SalidaBuffer(FILE* archivo) : archivo(archivo), ok(true) { buffer.reserve(1 << 16); }
+
+    void byte(unsigned char b) {
+        buffer.push_back(b);
+        if (buffer.size() >= (1 << 16)) vaciar();
+    }
+    void bytes(const unsigned char* datos, size_t n) {
+        vaciar();
+        ok = ok && fwrite(datos, 1, n, archivo) == n;
+    }
+    void entero32(uint32_t v) {
+        byte(static_cast<unsigned char>(v >> 24));
+        byte(static_cast<unsigned char>(v >> 16));
+        byte(static_cast<unsigned char>(v >> 8));
+        byte(static_cast<unsigned char>(v));
+    }
+    void vaciar() {
+        if (!buffer.empty()) {
+            ok = ok && fwrite(buffer.data(), 1, buffer.size(), archivo) == buffer.size();
+            buffer.clear();
+        }
+    }
+    bool cerrar() {
+        vaciar();
+        return (fclose(archivo) == 0) && ok;
+    }
+};
+
+} // namespace
+
+bool formatoDesdeTexto(const char* texto, FormatoImagen& formato) {
+    for (const auto& n : NOMBRES_FORMATO) {
+        if (std::strcmp(texto, n.nombre) == 0) {
+            formato = n.formato;
+            return true;
+        }
+    }
+    return false;
+}
+
+FormatoImagen formatoDesdeExtension(const std::string& filename) {
+    size_t punto = filename.find_last_of('.');
+    size_t barra = filename.find_last_of('/');
+    if (punto == std::string::npos || (barra != std::string::npos && punto < barra)) {
+        return FormatoImagen::Automatico;
+    }
+    std::string ext = filename.substr(punto + 1);
+    for (char& ch : ext) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+
+    FormatoImagen formato = FormatoImagen::Automatico;
+    formatoDesdeTexto(ext.c_str(), formato);
+    return formato;
+}
+
+const char* extensionFormato(FormatoImagen formato) {
+    switch (formato) {
+        case FormatoImagen::JPEG: return ".jpg";
+        case FormatoImagen::BMP: return ".bmp";
+        case FormatoImagen::TGA: return ".tga";
+        case FormatoImagen::PNM: return ".ppm";
+        case FormatoImagen::QOI: return ".qoi";
+        case FormatoImagen::HDR: return ".hdr";
+        default: return ".png";
+    }
+}
+
+FormatoImagen resolverFormatoSalida(const std::string& filename, FormatoImagen pedido, std::string& nombreFinal) {
+    FormatoImagen porExtension = formatoDesdeExtension(filename);
+    FormatoImagen formato = pedido;
+    if (formato == FormatoImagen::Automatico) {
+        formato = (porExtension == FormatoImagen::Automatico) ? FormatoImagen::PNG : porExtension;
+    }
+    nombreFinal = filename;
+    if (porExtension != formato) {
+        nombreFinal += extensionFormato(formato);
+    }
+    return formato;
+}
+
+bool guardarImagenPNM(const char* filename, const unsigned char* image, int width, int height, int channels) {
+    FILE* archivo = fopen(filename, "wb");
+    if (!archivo) return false;
+
+    // PNM no tiene canal alfa: se descarta si existe
+    bool gris = channels <= 2;
+    int canalesSalida = gris ? 1 : 3;
+    char cabecera[64];
+    int n = snprintf(cabecera, sizeof(cabecera), "%s\n%d %d\n255\n", gris ? "P5" : "P6", width, height);
+
+    SalidaBuffer salida(archivo);
+    salida.bytes(reinterpret_cast<const unsigned char*>(cabecera), n);
+    size_t pixeles = static_cast<size_t>(width) * height;
+    if (channels == canalesSalida) {
+        salida.bytes(image, pixeles * channels);
+    } else {
+        for (size_t i = 0; i < pixeles; ++i) {
+            for (int c = 0; c < canalesSalida; ++c) {
+                salida.byte(image[i * channels + c]);
+            }
+        }
+    }
+    return salida.cerrar();
+}
+
+bool guardarImagenQOI(const char* filename, const unsigned char* image, int width, int height, int channels) {
+    FILE* archivo = fopen(filename, "wb");
+    if (!archivo) return false;
+
+    // QOI solo admite RGB y RGBA; el gris se expande
+    bool alfa = (channels == 2 || channels == 4);
+    SalidaBuffer salida(archivo);
+    salida.bytes(reinterpret_cast<const unsigned char*>("qoif"), 4);
+    salida.entero32(static_cast<uint32_t>(width));
+    salida.entero32(static_cast<uint32_t>(height));
+    salida.byte(alfa ? 4 : 3);
+    salida.byte(0);   // sRGB
+
+    unsigned char indice[64][4] = {};
+    unsigned char anterior[4] = {0, 0, 0, 255};
+    int corrida = 0;
+    size_t pixeles = static_cast<size_t>(width) * height;
+
+    for (size_t i = 0; i < pixeles; ++i) {
+        const unsigned char* p = image + i * channels;
+        unsigned char px[4];
+        if (channels >= 3) {
+            px[0] = p[0]; px[1] = p[1]; px[2] = p[2];
+        } else {
+            px[0] = px[1] = px[2] = p[0];
+        }
+        px[3] = alfa ? p[channels - 1] : 255;
+
+        if (std::memcmp(px, anterior, 4) == 0) {
+            ++corrida;
+            if (corrida == 62 || i + 1 == pixeles) {
+                salida.byte(static_cast<unsigned char>(0xC0 | (corrida - 1)));
+                corrida = 0;
+            }
+            continue;
+        }
+        if (corrida > 0) {
+            salida.byte(static_cast<unsigned char>(0xC0 | (corrida - 1)));
+            corrida = 0;
+        }
+
+        int h = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+        if (std::memcmp(indice[h], px, 4) == 0) {
+            salida.byte(static_cast<unsigned char>(h));
+        } else {
+            std::memcpy(indice[h], px, 4);
+            if (px[3] == anterior[3]) {
+                int dr = static_cast<signed char>(px[0] - anterior[0]);
+                int dg = static_cast<signed char>(px[1] - anterior[1]);
+                int db = static_cast<signed char>(px[2] - anterior[2]);
+                int drg = dr - dg;
+                int dbg = db - dg;
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    salida.byte(static_cast<unsigned char>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                    salida.byte(static_cast<unsigned char>(0x80 | (dg + 32)));
+                    salida.byte(static_cast<unsigned char>((drg + 8) << 4 | (dbg + 8)));
+                } else {
+                    salida.byte(0xFE);
+                    salida.byte(px[0]); salida.byte(px[1]); salida.byte(px[2]);
+                }
+            } else {
+                salida.byte(0xFF);
+                salida.byte(px[0]); salida.byte(px[1]); salida.byte(px[2]); salida.byte(px[3]);
+            }
+        }
+        std::memcpy(anterior, px, 4);
+    }
+
+    static const unsigned char fin[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+    salida.bytes(fin, 8);
+    return salida.cerrar();
+}
+
+bool guardarImagenFormato(const char* filename, const unsigned char* image, int width, int height, int channels,
+                          FormatoImagen formato, const OpcionesGuardado& opciones) {
+    switch (formato) {
+        case FormatoImagen::JPEG:
+            return stbi_write_jpg(filename, width, height, channels, image, opciones.calidadJPEG) != 0;
+        case FormatoImagen::BMP:
+            return stbi_write_bmp(filename, width, height, channels, image) != 0;
+        case FormatoImagen::TGA:
+            return stbi_write_tga(filename, width, height, channels, image) != 0;
+        case FormatoImagen::PNM:
+            return guardarImagenPNM(filename, image, width, height, channels);
+        case FormatoImagen::QOI:
+            return guardarImagenQOI(filename, image, width, height, channels);
+        case FormatoImagen::HDR: {
+            size_t muestras = static_cast<size_t>(width) * height * channels;
+            std::vector<float> flotante = aFlotante(image, muestras, channels, 255.0f);
+            return stbi_write_hdr(filename, width, height, channels, flotante.data()) != 0;
+        }
+        default:
+            return guardarImagenPNG(filename, image, width, height, channels, opciones.png);
+    }
+}
+
+bool guardarImagenFormato16(const char* filename, const uint16_t* image, int width, int height, int channels,
+                            FormatoImagen formato, const OpcionesGuardado& opciones) {
+    size_t muestras = static_cast<size_t>(width) * height * channels;
+    if (formato == FormatoImagen::PNG || formato == FormatoImagen::Automatico) {
+        return guardarImagenPNG16(filename, image, width, height, channels, opciones.png);
+    }
+    if (formato == FormatoImagen::HDR) {
+        std::vector<float> flotante = aFlotante(image, muestras, channels, 65535.0f);
+        return stbi_write_hdr(filename, width, height, channels, flotante.data()) != 0;
+    }
+    std::vector<unsigned char> bytes(muestras);
+    for (size_t i = 0; i < muestras; ++i) {
+        bytes[i] = static_cast<unsigned char>((image[i] * 255u + 32767u) / 65535u);
+    }
+    return guardarImagenFormato(filename, bytes.data(), width, height, channels, formato, opciones);
+}
+
+bool guardarImagenFormatoFlotante(const char* filename, const float* image, int width, int height, int channels,
+                                  FormatoImagen formato, const OpcionesGuardado& opciones) {
+    if (formato == FormatoImagen::HDR) {
+        return stbi_write_hdr(filename, width, height, channels, image) != 0;
+    }
+    // Se pasa por 16 bits para que PNG conserve la precision
+    size_t muestras = static_cast<size_t>(width) * height * channels;
+    std::vector<uint16_t> enteros(muestras);
+    for (size_t i = 0; i < muestras; ++i) {
+        float v = std::min(1.0f, std::max(0.0f, image[i]));
+        if (!esCanalAlfa(i, channels)) v = std::pow(v, 1.0f / GAMMA_FLOTANTE);
+        enteros[i] = static_cast<uint16_t>(v * 65535.0f + 0.5f);
+    }
+    return guardarImagenFormato16(filename, enteros.data(), width, height, channels, formato, opciones);
+}
@@ -0,0 +1,459 @@
+#include "grafo_operaciones.h"
+#include "procesamiento_imagen.h"
+#include "planificador.h"
+#include "archivo_mapeado.h"
+#include "hash_contenido.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const size_t BYTES_POR_BLOQUE = 64 * 1024;
+
+void elegirBloque(EtapaPlan& etapa) {
+    // Bloques de ~64 KB de salida; 128 columnas mantienen cerca las filas de la fuente al rotar
+    etapa.bloqueAncho = std::min(etapa.width, 128);
+    int alto = static_cast<int>(BYTES_POR_BLOQUE / (static_cast<size_t>(etapa.bloqueAncho) * etapa.channels));
+    etapa.bloqueAlto = std::max(1, std::min(etapa.height, alto));
+}
+
+} // namespace
+
+void convertirCanales(const unsigned char* image, int width, int height, int channels,
+                      unsigned char* destino, int canalesDestino) {
+    bool alfaOrigen = (channels == 2 || channels == 4);
+    bool alfaDestino = (canalesDestino == 2 || canalesDestino == 4);
+    size_t pixeles = static_cast<size_t>(width) * height;
+
+    Planificador::global().paraCada(0, height, granoFilas(static_cast<size_t>(width) * canalesDestino), [&](int y0, int y1) {
+        for (size_t i = static_cast<size_t>(y0) * width; i < static_cast<size_t>(y1) * width && i < pixeles; ++i) {
+            const unsigned char* p = image + i * channels;
+            unsigned char* q = destino + i * canalesDestino;
+            unsigned char alfa = alfaOrigen ? p[channels - 1] : 255;
+            if (canalesDestino >= 3) {
+                if (channels >= 3) {
+                    q[0] = p[0]; q[1] = p[1]; q[2] = p[2];
+                } else {
+                    q[0] = q[1] = q[2] = p[0];
+                }
+            } else {
+                // Luma BT.601
+                q[0] = channels >= 3 ? static_cast<unsigned char>((p[0] * 299 + p[1] * 587 + p[2] * 114 + 500) / 1000) : p[0];
+            }
+            if (alfaDestino) {
+                q[canalesDestino - 1] = alfa;
+            }
+        }
+    });
+}
+
+GrafoOperaciones::GrafoOperaciones()
+    : memoriaOrigen(nullptr), widthOrigen(0), heightOrigen(0), channelsOrigen(0),
+      modoInterpolacion(Interpolacion::Bilineal), huellaOrigenGuardada(0), huellaOrigenCalculada(false) {}
+
+GrafoOperaciones GrafoOperaciones::cargar(const std::string& filename) {
+    GrafoOperaciones grafo;
+    grafo.archivoOrigen = filename;
+    return grafo;
+}
+
+GrafoOperaciones GrafoOperaciones::desdeMemoria(const unsigned char* image, int width, int height, int channels) {
+    GrafoOperaciones grafo;
+    grafo.memoriaOrigen = image;
+    grafo.widthOrigen = width;
+    grafo.heightOrigen = height;
+    grafo.channelsOrigen = channels;
+    return grafo;
+}
+
+GrafoOperaciones& GrafoOperaciones::rotar(float angle) {
+    Operacion op{TipoOperacion::Rotar};
+    op.valor = angle;
+    operaciones.push_back(op);
+    return *this;
+}
+
+GrafoOperaciones& GrafoOperaciones::escalar(float scaleFactor) {
+    Operacion op{TipoOperacion::Escalar};
+    op.valor = scaleFactor;
+    operaciones.push_back(op);
+    return *this;
+}
+
+GrafoOperaciones& GrafoOperaciones::recortar(int x, int y, int width, int height) {
+    Operacion op{TipoOperacion::Recortar};
+    op.x = x;
+    op.y = y;
+    op.w = width;
+    op.h = height;
+    operaciones.push_back(op);
+    return *this;
+}
+
+GrafoOperaciones& GrafoOperaciones::convertir(int channels) {
+    Operacion op{TipoOperacion::Convertir};
+    op.canales = channels;
+    operaciones.push_back(op);
+    return *this;
+}
+
+GrafoOperaciones& GrafoOperaciones::interpolacion(Interpolacion modo) {
+    modoInterpolacion = modo;
+    return *this;
+}
+
+bool GrafoOperaciones::dimensionesOrigen(int& width, int& height, int& channels) const {
+    if (memoriaOrigen) {
+        width = widthOrigen;
+        height = heightOrigen;
+        channels = channelsOrigen;
+        return true;
+    }
+    // Solo lee la cabecera: no hace falta decodificar para planificar
+    return stbi_info(archivoOrigen.c_str(), &width, &height, &channels) != 0;
+}
+
+bool GrafoOperaciones::planificar(std::vector<EtapaPlan>& plan, int& eliminadas) const {
+    plan.clear();
+    eliminadas = 0;
+
+    int w, h, ch;
+    if (!dimensionesOrigen(w, h, ch)) {
+        std::cerr << "Error: No se pudo leer la cabecera de " << archivoOrigen << "\n";
+        return false;
+    }
+
+    // Transformacion geometrica pendiente (fuente -> destino) desde la ultima etapa
+    MatrizAfin directa;
+    int pendientes = 0;
+    int wEtapa = w, hEtapa = h;
+
+    auto cerrarTransformacion = [&]() {
+        if (pendientes == 0) return;
+        if (directa.esIdentidad() && w == wEtapa && h == hEtapa) {
+            eliminadas += pendientes;   // Las operaciones se cancelaron entre si
+        } else {
+            EtapaPlan etapa;
+            etapa.tipo = EtapaPlan::Transformacion;
+            etapa.inversa = directa.inversa();
+            etapa.width = w;
+            etapa.height = h;
+            etapa.channels = ch;
+            etapa.operacionesFusionadas = pendientes;
+            elegirBloque(etapa);
+            plan.push_back(etapa);
+        }
+        directa = MatrizAfin::identidad();
+        pendientes = 0;
+        wEtapa = w;
+        hEtapa = h;
+    };
+
+    for (const Operacion& op : operaciones) {
+        if (op.tipo == TipoOperacion::Convertir) {
+            if (op.canales == ch || op.canales < 1 || op.canales > 4) {
+                ++eliminadas;
+                continue;
+            }
+            cerrarTransformacion();
+            EtapaPlan etapa;
+            etapa.tipo = EtapaPlan::Conversion;
+            etapa.width = w;
+            etapa.height = h;
+            etapa.channels = op.canales;
+            etapa.operacionesFusionadas = 1;
+            elegirBloque(etapa);
+            plan.push_back(etapa);
+            ch = op.canales;
+            continue;
+        }
+
+        MatrizAfin m;
+        int nw = w, nh = h;
+        switch (op.tipo) {
+            case TipoOperacion::Rotar:
+                if (std::fmod(op.valor, 360.0f) == 0.0f) {
+                    ++eliminadas;
+                    continue;
+                }
+                m = matrizRotacionImagen(w, h, op.valor, nw, nh);
+                break;
+            case TipoOperacion::Escalar:
+                if (!(op.valor > 0.0f)) {
+                    std::cerr << "Error: El factor de escala debe ser mayor que 0 (recibido " << op.valor << ")\n";
+                    return false;
+                }
+                if (op.valor == 1.0f) {
+                    ++eliminadas;
+                    continue;
+                }
+                m = matrizEscalaImagen(w, h, op.valor, nw, nh);
+                break;
+            default:   // Recortar
+                if (op.w <= 0 || op.h <= 0) {
+                    std::cerr << "Error: El recorte debe tener ancho y alto positivos (recibido " << op.w << "x" << op.h << ")\n";
+                    return false;
+                }
+                if (op.x == 0 && op.y == 0 && op.w == w && op.h == h) {
+                    ++eliminadas;
+                    continue;
+                }
+                nw = op.w;
+                nh = op.h;
+                m = MatrizAfin::traslacion(-op.x, -op.y);
+                break;
+        }
+        if (nw <= 0 || nh <= 0) {
+            std::cerr << "Error: La operación produce una imagen vacía\n";
+            return false;
+        }
+        directa = m.componer(directa);
+        ++pendientes;
+        w = nw;
+        h = nh;
+    }
+    cerrarTransformacion();
+    return true;
+}
+
+std::string GrafoOperaciones::describirPlan() const {
+    std::vector<EtapaPlan> plan;
+    int eliminadas = 0;
+    std::ostringstream texto;
+    if (!planificar(plan, eliminadas)) {
+        return "Plan inválido\n";
+    }
+    texto << "Operaciones: " << operaciones.size() << " | Etapas: " << plan.size()
+          << " | Eliminadas: " << eliminadas << "\n";
+    for (const EtapaPlan& etapa : plan) {
+        if (etapa.tipo == EtapaPlan::Transformacion) {
+            texto << "  - Transformación afín (" << etapa.operacionesFusionadas << " op. fusionadas)";
+        } else {
+            texto << "  - Conversión a " << etapa.channels << " canales";
+        }
+        texto << " -> " << etapa.width << "x" << etapa.height
+              << " | Bloques " << etapa.bloqueAncho << "x" << etapa.bloqueAlto << "\n";
+    }
+    return texto.str();
+}
+
+bool GrafoOperaciones::ejecutar(BufferImagen& resultado) const {
+    std::vector<EtapaPlan> plan;
+    int eliminadas = 0;
+    if (!planificar(plan, eliminadas)) {
+        return false;
+    }
+
+    int w, h, ch;
+    unsigned char* decodificada = nullptr;
+    const unsigned char* actual = memoriaOrigen;
+    if (memoriaOrigen) {
+        w = widthOrigen;
+        h = heightOrigen;
+        ch = channelsOrigen;
+    } else {
+        decodificada = cargarImagen(archivoOrigen.c_str(), w, h, ch);
+        if (!decodificada) {
+            std::cerr << "Error: No se pudo cargar " << archivoOrigen << "\n";
+            return false;
+        }
+        actual = decodificada;
+    }
+
+    // Se alternan dos buffers: la salida de una etapa es la entrada de la siguiente
+    std::vector<unsigned char> buffers[2];
+    int siguiente = 0;
+    for (const EtapaPlan& etapa : plan) {
+        std::vector<unsigned char>& destino = buffers[siguiente];
+        destino.resize(static_cast<size_t>(etapa.width) * etapa.height * etapa.channels);
+        if (etapa.tipo == EtapaPlan::Transformacion) {
+            aplicarTransformacionAfin(actual, w, h, ch, etapa.inversa, destino.data(), etapa.width, etapa.height,
+                                      modoInterpolacion, etapa.bloqueAncho, etapa.bloqueAlto);
+        } else {
+            convertirCanales(actual, w, h, ch, destino.data(), etapa.channels);
+        }
+        actual = destino.data();
+        w = etapa.width;
+        h = etapa.height;
+        ch = etapa.channels;
+        siguiente ^= 1;
+    }
+
+    resultado.width = w;
+    resultado.height = h;
+    resultado.channels = ch;
+    if (plan.empty()) {
+        resultado.pixeles.assign(actual, actual + static_cast<size_t>(w) * h * ch);
+    } else {
+        resultado.pixeles.swap(buffers[siguiente ^ 1]);
+    }
+    if (decodificada) {
+        stbi_image_free(decodificada);
+    }
+    return true;
+}
+
+bool GrafoOperaciones::tamanoSalida(int& width, int& height, int& channels) const {
+    std::vector<EtapaPlan> plan;
+    int eliminadas = 0;
+    if (!planificar(plan, eliminadas)) return false;
+    if (plan.empty()) return dimensionesOrigen(width, height, channels);
+    width = plan.back().width;
+    height = plan.back().height;
+    channels = plan.back().channels;
+    return true;
+}
+
+Rectangulo GrafoOperaciones::rectanguloBloque(int bx, int by) const {
+    Rectangulo bloque;
+    bloque.x = bx * TAMANO_BLOQUE_REGION;
+    bloque.y = by * TAMANO_BLOQUE_REGION;
+    bloque.width = TAMANO_BLOQUE_REGION;
+    bloque.height = TAMANO_BLOQUE_REGION;
+    return bloque;
+}
+
+bool GrafoOperaciones::ejecutarBloque(int bx, int by, BufferImagen& resultado) const {
+    return ejecutarRegion(rectanguloBloque(bx, by), resultado);
+}
+
+bool GrafoOperaciones::ejecutarBloque(const std::vector<EtapaPlan>& plan, int bx, int by, BufferImagen& resultado) const {
+    return ejecutarRegion(plan, rectanguloBloque(bx, by), resultado);
+}
+
+bool GrafoOperaciones::ejecutarRegion(const Rectangulo& region, BufferImagen& resultado) const {
+    std::vector<EtapaPlan> plan;
+    int eliminadas = 0;
+    if (!planificar(plan, eliminadas)) return false;
+    return ejecutarRegion(plan, region, resultado);
+}
+
+bool GrafoOperaciones::ejecutarRegion(const std::vector<EtapaPlan>& plan, const Rectangulo& region,
+                                      BufferImagen& resultado) const {
+    int w0, h0, ch0;
+    if (!dimensionesOrigen(w0, h0, ch0)) {
+        return false;
+    }
+
+    // Rectangulo pedido a la salida de cada etapa, de la ultima hacia la primera
+    int wFinal = plan.empty() ? w0 : plan.back().width;
+    int hFinal = plan.empty() ? h0 : plan.back().height;
+    Rectangulo completo;
+    completo.width = wFinal;
+    completo.height = hFinal;
+    Rectangulo pedido = region.interseccion(completo);
+    if (pedido.vacio()) {
+        std::cerr << "Error: La región está fuera de la imagen\n";
+        return false;
+    }
+
+    std::vector<Rectangulo> salidas(plan.size());
+    Rectangulo entrada = pedido;
+    for (size_t i = plan.size(); i-- > 0;) {
+        salidas[i] = entrada;
+        if (plan[i].tipo == EtapaPlan::Transformacion) {
+            int wEntrada = i > 0 ? plan[i - 1].width : w0;
+            int hEntrada = i > 0 ? plan[i - 1].height : h0;
+            entrada = proyectarRectangulo(plan[i].inversa, entrada, wEntrada, hEntrada);
+        }
+    }
+
+    // Leer solo la parte necesaria de la fuente
+    std::vector<unsigned char> actual;
+    int ch = ch0;
+    if (!entrada.vacio()) {
+        actual.resize(static_cast<size_t>(entrada.width) * entrada.height * ch0);
+        if (memoriaOrigen) {
+            size_t bytesFila = static_cast<size_t>(entrada.width) * ch0;
+            for (int y = 0; y < entrada.height; ++y) {
+                std::memcpy(actual.data() + y * bytesFila,
+                            memoriaOrigen + ((static_cast<size_t>(entrada.y) + y) * w0 + entrada.x) * ch0, bytesFila);
+            }
+        } else {
+            int w, h;
+            unsigned char* region = cargarRegionImagen(archivoOrigen.c_str(), entrada.x, entrada.y,
+                                                       entrada.width, entrada.height, w, h, ch);
+            if (!region) {
+                std::cerr << "Error: No se pudo cargar " << archivoOrigen << "\n";
+                return false;
+            }
+            std::memcpy(actual.data(), region, actual.size());
+            delete[] region;
+        }
+    }
+
+    Rectangulo rectActual = entrada;
+    for (size_t i = 0; i < plan.size(); ++i) {
+        const EtapaPlan& etapa = plan[i];
+        const Rectangulo& rectSalida = salidas[i];
+        std::vector<unsigned char> destino(static_cast<size_t>(rectSalida.width) * rectSalida.height * etapa.channels, 0);
+
+        if (etapa.tipo == EtapaPlan::Transformacion) {
+            if (!rectActual.vacio()) {
+                aplicarTransformacionAfin(actual.data(), rectActual, ch, etapa.inversa, destino.data(), rectSalida,
+                                          modoInterpolacion, std::min(etapa.bloqueAncho, rectSalida.width),
+                                          std::min(etapa.bloqueAlto, rectSalida.height));
+            }
+        } else {
+            convertirCanales(actual.data(), rectSalida.width, rectSalida.height, ch, destino.data(), etapa.channels);
+        }
+        actual.swap(destino);
+        rectActual = rectSalida;
+        ch = etapa.channels;
+    }
+
+    resultado.pixeles.swap(actual);
+    resultado.width = pedido.width;
+    resultado.height = pedido.height;
+    resultado.channels = ch;
+    return true;
+}
+
+uint64_t GrafoOperaciones::huellaOrigen() const {
+    if (!huellaOrigenCalculada) {
+        if (memoriaOrigen) {
+            int dims[3] = {widthOrigen, heightOrigen, channelsOrigen};
+            huellaOrigenGuardada = combinarHash(hashContenido(dims, sizeof(dims)),
+                                                hashContenido(memoriaOrigen, static_cast<size_t>(widthOrigen) * heightOrigen * channelsOrigen));
+        } else {
+            ArchivoMapeado archivo;
+            huellaOrigenGuardada = archivo.abrir(archivoOrigen.c_str())
+                                       ? hashContenido(archivo.data(), archivo.size())
+                                       : hashContenido(archivoOrigen.data(), archivoOrigen.size());
+        }
+        huellaOrigenCalculada = true;
+    }
+    return huellaOrigenGuardada;
+}
+
+uint64_t GrafoOperaciones::huellaTransformacion() const {
+    std::vector<EtapaPlan> plan;
+    int eliminadas = 0;
+    if (!planificar(plan, eliminadas)) return hashContenido(&modoInterpolacion, sizeof(modoInterpolacion));
+    return huellaTransformacion(plan);
+}
+
+uint64_t GrafoOperaciones::huellaTransformacion(const std::vector<EtapaPlan>& plan) const {
+    uint64_t h = hashContenido(&modoInterpolacion, sizeof(modoInterpolacion));
+    for (const EtapaPlan& etapa : plan) {
+        double valores[10] = {static_cast<double>(etapa.tipo), etapa.inversa.a, etapa.inversa.b, etapa.inversa.c,
+                              etapa.inversa.d, etapa.inversa.e, etapa.inversa.f,
+                              static_cast<double>(etapa.width), static_cast<double>(etapa.height),
+                              static_cast<double>(etapa.channels)};
+        h = combinarHash(h, hashContenido(valores, sizeof(valores)));
+    }
+    return h;
+}
+
+bool GrafoOperaciones::guardar(const std::string& filename, const OpcionesGuardado& opciones) const {
+    BufferImagen resultado;
+    if (!ejecutar(resultado)) {
+        return false;
+    }
+    return guardarImagen(filename.c_str(), resultado.pixeles.data(), resultado.width, resultado.height,
+                         resultado.channels, opciones);
+}
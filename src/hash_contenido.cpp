@@ -0,0 +1,62 @@
+#include "hash_contenido.h"
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+const uint64_t PRIMO1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIMO2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t rotar(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t mezclar(uint64_t h) {
+    h ^= h >> 33;
+    h *= PRIMO2;
+    h ^= h >> 29;
+    h *= PRIMO1;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace
+
+uint64_t hashContenido(const void* datos, size_t n, uint64_t semilla) {
+    const unsigned char* p = static_cast<const unsigned char*>(datos);
+    uint64_t h = semilla ^ (n * PRIMO1);
+
+    // Cuatro acumuladores independientes para no depender de la latencia de la multiplicacion
+    uint64_t acc[4] = {h + PRIMO1, h + PRIMO2, h, h - PRIMO1};
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        for (int k = 0; k < 4; ++k) {
+            uint64_t v;
+            std::memcpy(&v, p + i + 8 * k, 8);
+            acc[k] = rotar(acc[k] + v * PRIMO2, 31) * PRIMO1;
+        }
+    }
+    h = rotar(acc[0], 1) + rotar(acc[1], 7) + rotar(acc[2], 12) + rotar(acc[3], 18);
+
+    for (; i + 8 <= n; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, p + i, 8);
+        h = rotar(h ^ (v * PRIMO2), 27) * PRIMO1;
+    }
+    for (; i < n; ++i) {
+        h = rotar(h ^ (p[i] * PRIMO1), 11) * PRIMO2;
+    }
+    return mezclar(h);
+}
+
+uint64_t combinarHash(uint64_t a, uint64_t b) {
+    return mezclar(a ^ (b + PRIMO1 + (a << 6) + (a >> 2)));
+}
+
+std::string huellaHexadecimal(const void* datos, size_t n) {
+    char texto[33];
+    snprintf(texto, sizeof(texto), "%016llx%016llx",
+             static_cast<unsigned long long>(hashContenido(datos, n, 0)),
+             static_cast<unsigned long long>(hashContenido(datos, n, PRIMO2)));
+    return texto;
+}
@@ -1,133 +1,443 @@
-#include <iostream>
-#include <chrono>
-#include <cstring>
-#include <stdexcept>
-#include <iomanip>
-#include <sys/resource.h>
-
-#include "buddy_system.h"
-#include "procesamiento_imagen.h"
-#include "stb_image.h"
-#include "stb_image_write.h"
-
-long obtener_memoria_kb() {
-    struct rusage usage;
-    getrusage(RUSAGE_SELF, &usage);
-    return usage.ru_maxrss; // En KB
-}
-
-void mostrar_ayuda() {
-    std::cout << "Uso: ./programa_imagen entrada.jpg salida.jpg -angulo 45 -escalar 1.5 [-buddy]\n";
-}
-
-int main(int argc, char* argv[]) {
-    std::string inputFilename, outputFilename;
-    float angle = 0.0f;
-    float scaleFactor = 1.0f;
-    const size_t buddyMemory = 20 * 1024 * 1024; // 20 MB
-    bool usarBuddy = false;
-
-    if (argc < 6) {
-        mostrar_ayuda();
-        return 1;
-    }
-
-    try {
-        inputFilename = argv[1];
-        outputFilename = argv[2];
-
-        for (int i = 3; i < argc; i++) {
-            std::string arg = argv[i];
-            if (arg == "-angulo" && i + 1 < argc) {
-                angle = std::stof(argv[++i]);
-            } else if (arg == "-escalar" && i + 1 < argc) {
-                scaleFactor = std::stof(argv[++i]);
-            } else if (arg == "-buddy") {
-                usarBuddy = true;
-            }
-        }
-
-        std::cout << "Imagen: " << inputFilename << "\n";
-        std::cout << "Ángulo: " << angle << " | Escala: " << scaleFactor << "\n";
-
-        int width, height, channels;
-        unsigned char* originalImage = stbi_load(inputFilename.c_str(), &width, &height, &channels, 0);
-        if (!originalImage) throw std::runtime_error("Error al cargar la imagen");
-
-        size_t inputSize = width * height * channels;
-        std::cout << "Dimensiones: " << width << "x" << height << " | Canales: " << channels << "\n\n";
-
-        // ========== MODO CONVENCIONAL ==========
-        std::cout << "=== MODO CONVENCIONAL ===\n";
-        long memAntesConv = obtener_memoria_kb();
-        auto startConv = std::chrono::high_resolution_clock::now();
-
-        unsigned char* imageCopy = new unsigned char[inputSize];
-        memcpy(imageCopy, originalImage, inputSize);
-
-        int rotW1, rotH1;
-        unsigned char* rotadaConv = rotarImagen(imageCopy, width, height, channels, angle, rotW1, rotH1);
-        delete[] imageCopy;
-
-        int escW1, escH1;
-        unsigned char* escaladaConv = escalarImagen(rotadaConv, rotW1, rotH1, channels, scaleFactor, escW1, escH1);
-        delete[] rotadaConv;
-
-        auto endConv = std::chrono::high_resolution_clock::now();
-        long memDespConv = obtener_memoria_kb();
-        double tiempoConv = std::chrono::duration<double, std::milli>(endConv - startConv).count();
-
-        std::cout << "[CONVENCIONAL] Tiempo total: " << tiempoConv << " ms\n";
-        std::cout << "[CONVENCIONAL] Memoria estimada: " << ((rotW1 * rotH1 + escW1 * escH1) * channels) / 1024.0 << " KB\n";
-        std::cout << "[CONVENCIONAL] Memoria real usada: " << (memDespConv - memAntesConv) / 1024.0 << " MB\n";
-
-        guardarImagen(("conv_" + outputFilename).c_str(), escaladaConv, escW1, escH1, channels);
-        std::cout << "[CONVENCIONAL] Imagen escalada: " << escW1 << "x" << escH1 << "\n";
-
-        delete[] escaladaConv;
-
-        std::cout << "Imagen guardada como: conv_" << outputFilename << "\n\n";
-
-        // ========== MODO BUDDY (si se activó el flag) ==========
-        if (usarBuddy) {
-            std::cout << "=== MODO BUDDY ===\n";
-            long memAntesBuddy = obtener_memoria_kb();
-            auto startBuddy = std::chrono::high_resolution_clock::now();
-
-            BuddySystem buddy(buddyMemory);
-            unsigned char* imageBuddy = static_cast<unsigned char*>(buddy.allocate(inputSize));
-            if (!imageBuddy) throw std::runtime_error("No se pudo asignar memoria con Buddy");
-            memcpy(imageBuddy, originalImage, inputSize);
-
-            int rotW2, rotH2;
-            unsigned char* rotadaBuddy = rotarImagen(imageBuddy, width, height, channels, angle, buddy, rotW2, rotH2);
-            buddy.free(imageBuddy);
-
-            int escW2, escH2;
-            unsigned char* escaladaBuddy = escalarImagen(rotadaBuddy, rotW2, rotH2, channels, scaleFactor, buddy, escW2, escH2);
-            buddy.free(rotadaBuddy);
-
-            auto endBuddy = std::chrono::high_resolution_clock::now();
-            long memDespBuddy = obtener_memoria_kb();
-            double tiempoBuddy = std::chrono::duration<double, std::milli>(endBuddy - startBuddy).count();
-
-            std::cout << "[BUDDY] Tiempo total: " << tiempoBuddy << " ms\n";
-            std::cout << "[BUDDY] Memoria estimada: " << ((rotW2 * rotH2 + escW2 * escH2) * channels) / 1024.0 << " KB\n";
-            std::cout << "[BUDDY] Memoria real usada: " << (memDespBuddy - memAntesBuddy) / 1024.0 << " MB\n";
-
-            guardarImagen(("buddy_" + outputFilename).c_str(), escaladaBuddy, escW2, escH2, channels);
-            std::cout << "[BUDDY] Imagen escalada: " << escW2 << "x" << escH2 << "\n";
-            buddy.free(escaladaBuddy);
-
-            std::cout << "Imagen guardada como: buddy_" << outputFilename << "\n";
-        }
-
-        std::cout << "------------------------\n";
-        stbi_image_free(originalImage);
-    } catch (const std::exception& e) {
-        std::cerr << "ERROR: " << e.what() << "\n";
-        return 1;
-    }
-
-    return 0;
-}
+#include <iostream>
+#include <chrono>
+#include <memory>
+#include <cstring>
+#include <stdexcept>
+#include <iomanip>
+#include <cstdio>
+#include <type_traits>
+
+#include "buddy_system.h"
+#include "procesamiento_imagen.h"
+#include "procesamiento_lote.h"
+#include "planificador.h"
+#include "grafo_operaciones.h"
+#include "cache_bloques.h"
+#include "cache_resultados.h"
+#include "memoria.h"
+#include "traza.h"
+#include "contadores_hardware.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+
+// Escribe la traza al salir de main por cualquier camino
+struct VolcadoTraza {
+    std::string archivo;
+    ~VolcadoTraza() {
+        if (archivo.empty()) return;
+        if (guardarTraza(archivo.c_str())) std::cout << "Traza guardada en: " << archivo << "\n";
+        else std::cerr << "Error al guardar la traza en " << archivo << "\n";
+    }
+};
+
+void mostrar_ayuda() {
+    std::cout << "Uso: ./programa_imagen entrada.jpg salida.jpg -angulo 45 -escalar 1.5 [-buddy]\n";
+    std::cout << "       [-formato png|jpg|bmp|tga|ppm|qoi|hdr] [-calidad 1-100]\n";
+    std::cout << "       [-compresion 0-9] [-filtro ninguno|sub|arriba|promedio|paeth|adaptativo] [-hilos N] [-fijar-nucleos]\n";
+    std::cout << "       [-fondo transparente|extender|repetir|alfa|R,G,B[,A]] [-interpolacion vecino|bilineal|lineal]\n";
+    std::cout << "       [-cache-resultados DIR] [-cache-limite MB] [-traza archivo.json] [-contadores]\n";
+    std::cout << "       [-grafo [-recortar x,y,ancho,alto] [-canales N] [-vecino] [-region x,y,ancho,alto] [-cache-bloques MB]]\n";
+    std::cout << "Lote: ./programa_imagen -lote <directorio|patrón|manifiesto> \"{nombre}_salida.png\" [opciones]\n";
+    std::cout << "       [-tuberia D,T,E] (hilos de decodificación, transformación y codificación)\n";
+    std::cout << "       [-pool-limite MB] (buffers reciclados entre imágenes, 0 = sin pool)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string inputFilename, outputFilename;
+    float angle = 0.0f;
+    float scaleFactor = 1.0f;
+    const size_t buddyMemory = 20 * 1024 * 1024; // 20 MB
+    bool usarBuddy = false;
+    OpcionesGuardado opcionesSalida;
+    OpcionesLote lote;
+    int hilos = 0;
+    bool fijarNucleos = false;
+    bool usarGrafo = false;
+    Interpolacion interpolacion = Interpolacion::Bilineal;
+    int recorte[4] = {0, 0, 0, 0};
+    bool conRecorte = false;
+    int region[4] = {0, 0, 0, 0};
+    int canalesSalida = 0;
+    size_t cacheBloquesMB = 0;
+    std::string directorioCache;
+    size_t limiteCacheMB = 512;
+    std::string archivoTraza;
+    bool usarContadores = false;
+    FondoTransformacion fondo;
+
+    bool modoLote = argc > 1 && std::string(argv[1]) == "-lote";
+    if (argc < (modoLote ? 4 : 6)) {
+        mostrar_ayuda();
+        return 1;
+    }
+
+    VolcadoTraza volcadoTraza;
+    try {
+        int primeraOpcion = modoLote ? 4 : 3;
+        inputFilename = argv[primeraOpcion - 2];
+        outputFilename = argv[primeraOpcion - 1];
+
+        for (int i = primeraOpcion; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "-angulo" && i + 1 < argc) {
+                angle = std::stof(argv[++i]);
+            } else if (arg == "-escalar" && i + 1 < argc) {
+                scaleFactor = std::stof(argv[++i]);
+            } else if (arg == "-buddy") {
+                usarBuddy = true;
+            } else if (arg == "-formato" && i + 1 < argc) {
+                if (!formatoDesdeTexto(argv[++i], opcionesSalida.formato)) {
+                    throw std::runtime_error(std::string("Formato de salida desconocido: ") + argv[i]);
+                }
+            } else if (arg == "-calidad" && i + 1 < argc) {
+                opcionesSalida.calidadJPEG = std::stoi(argv[++i]);
+            } else if (arg == "-tuberia" && i + 1 < argc) {
+                lote.tuberia = true;
+                if (sscanf(argv[++i], "%d,%d,%d", &lote.hilosDecodificacion, &lote.hilosTransformacion,
+                           &lote.hilosCodificacion) != 3) {
+                    throw std::runtime_error("Formato de -tuberia inválido (se espera D,T,E)");
+                }
+            } else if (arg == "-hilos" && i + 1 < argc) {
+                hilos = std::stoi(argv[++i]);
+            } else if (arg == "-grafo") {
+                usarGrafo = true;
+            } else if (arg == "-vecino") {
+                interpolacion = Interpolacion::Vecino;
+            } else if (arg == "-interpolacion" && i + 1 < argc) {
+                if (!interpolacionDesdeTexto(argv[++i], interpolacion)) {
+                    throw std::runtime_error(std::string("Interpolación desconocida: ") + argv[i]);
+                }
+            } else if (arg == "-recortar" && i + 1 < argc) {
+                if (sscanf(argv[++i], "%d,%d,%d,%d", &recorte[0], &recorte[1], &recorte[2], &recorte[3]) != 4) {
+                    throw std::runtime_error("Formato de -recortar inválido (se espera x,y,ancho,alto)");
+                }
+                conRecorte = true;
+            } else if (arg == "-region" && i + 1 < argc) {
+                if (sscanf(argv[++i], "%d,%d,%d,%d", &region[0], &region[1], &region[2], &region[3]) != 4) {
+                    throw std::runtime_error("Formato de -region inválido (se espera x,y,ancho,alto)");
+                }
+            } else if (arg == "-cache-resultados" && i + 1 < argc) {
+                directorioCache = argv[++i];
+            } else if (arg == "-contadores") {
+                usarContadores = true;
+            } else if (arg == "-traza" && i + 1 < argc) {
+                archivoTraza = argv[++i];
+            } else if (arg == "-cache-limite" && i + 1 < argc) {
+                limiteCacheMB = std::stoul(argv[++i]);
+            } else if (arg == "-fondo" && i + 1 < argc) {
+                if (!fondoDesdeTexto(argv[++i], fondo)) {
+                    throw std::runtime_error(std::string("Fondo desconocido: ") + argv[i]);
+                }
+            } else if (arg == "-pool-limite" && i + 1 < argc) {
+                lote.limitePool = std::stoul(argv[++i]) * 1024 * 1024;
+            } else if (arg == "-cache-bloques" && i + 1 < argc) {
+                cacheBloquesMB = std::stoul(argv[++i]);
+            } else if (arg == "-canales" && i + 1 < argc) {
+                canalesSalida = std::stoi(argv[++i]);
+            } else if (arg == "-fijar-nucleos") {
+                fijarNucleos = true;
+            } else if (arg == "-compresion" && i + 1 < argc) {
+                opcionesSalida.png.nivel = nivelDesdeEntero(std::stoi(argv[++i]));
+            } else if (arg == "-filtro" && i + 1 < argc) {
+                if (!filtroDesdeTexto(argv[++i], opcionesSalida.png.filtro)) {
+                    throw std::runtime_error(std::string("Filtro PNG desconocido: ") + argv[i]);
+                }
+            }
+        }
+
+        // La traza se activa antes de crear los hilos para que tengan nombre en el visor
+        if (!archivoTraza.empty()) {
+            iniciarTraza();
+            volcadoTraza.archivo = archivoTraza;
+        }
+
+        // Un solo planificador para todo el proceso (kernels y codificador PNG)
+        Planificador::configurar(hilos, fijarNucleos);
+
+        // Se abren despues de crear el planificador para cubrir a sus hilos
+        std::unique_ptr<ContadoresHardware> contadores;
+        if (usarContadores) {
+            contadores.reset(new ContadoresHardware());
+            if (!contadores->abrir()) {
+                std::cerr << "[CONTADORES] " << contadores->motivo() << "; se continúa sin contadores\n";
+                contadores.reset();
+            }
+        }
+
+        std::unique_ptr<CacheResultados> cacheResultados;
+        if (!directorioCache.empty()) {
+            cacheResultados.reset(new CacheResultados(directorioCache, limiteCacheMB * 1024 * 1024));
+            if (!cacheResultados->preparar()) cacheResultados.reset();
+        }
+
+        if (modoLote) {
+            lote.angle = angle;
+            lote.scaleFactor = scaleFactor;
+            lote.usarBuddy = usarBuddy;
+            lote.memoriaBuddy = buddyMemory;
+            lote.plantilla = outputFilename;
+            lote.salida = opcionesSalida;
+            lote.cache = cacheResultados.get();
+            lote.fondo = fondo;
+            lote.interpolacion = interpolacion;
+
+            std::vector<std::string> entradas = listarEntradasLote(inputFilename);
+            if (entradas.empty()) throw std::runtime_error("No se encontraron imágenes en " + inputFilename);
+            return procesarLote(entradas, lote) == 0 ? 0 : 1;
+        }
+
+        std::cout << "Imagen: " << inputFilename << "\n";
+        std::cout << "Ángulo: " << angle << " | Escala: " << scaleFactor << "\n";
+
+        // ========== MODO GRAFO ==========
+        if (usarGrafo) {
+            GrafoOperaciones grafo = GrafoOperaciones::cargar(inputFilename);
+            grafo.rotar(angle).escalar(scaleFactor);
+            if (conRecorte) grafo.recortar(recorte[0], recorte[1], recorte[2], recorte[3]);
+            if (canalesSalida > 0) grafo.convertir(canalesSalida);
+            grafo.interpolacion(interpolacion);
+
+            std::cout << "=== MODO GRAFO ===\n" << grafo.describirPlan();
+            auto startGrafo = std::chrono::high_resolution_clock::now();
+            BufferImagen resultado;
+            if (region[2] > 0 && region[3] > 0) {
+                // Solo se calcula la región pedida de la salida
+                Rectangulo pedido;
+                pedido.x = region[0];
+                pedido.y = region[1];
+                pedido.width = region[2];
+                pedido.height = region[3];
+                if (cacheBloquesMB > 0) {
+                    // La región se arma con bloques cacheados; la segunda pasada solo debe tener aciertos
+                    CacheBloques cache(cacheBloquesMB * 1024 * 1024);
+                    if (!cache.renderizarRegion(grafo, pedido, resultado)) throw std::runtime_error("Error al ejecutar la región del grafo");
+                    auto startRepetida = std::chrono::high_resolution_clock::now();
+                    cache.renderizarRegion(grafo, pedido, resultado);
+                    auto endRepetida = std::chrono::high_resolution_clock::now();
+                    EstadisticasCache stats = cache.estadisticas();
+                    std::cout << "[CACHE] Aciertos: " << stats.aciertos << " | Fallos: " << stats.fallos
+                              << " | Desalojos: " << stats.desalojos << " | Bloques: " << stats.bloques
+                              << " | Memoria: " << stats.bytesUsados / 1024 << " KB\n";
+                    std::cout << "[CACHE] Repetición desde caché: "
+                              << std::chrono::duration<double, std::milli>(endRepetida - startRepetida).count() << " ms\n";
+                } else if (!grafo.ejecutarRegion(pedido, resultado)) {
+                    throw std::runtime_error("Error al ejecutar la región del grafo");
+                }
+            } else if (!grafo.ejecutar(resultado)) {
+                throw std::runtime_error("Error al ejecutar el grafo");
+            }
+            auto endGrafo = std::chrono::high_resolution_clock::now();
+            std::cout << "[GRAFO] Tiempo total: " << std::chrono::duration<double, std::milli>(endGrafo - startGrafo).count() << " ms\n";
+
+            if (!guardarImagen(("grafo_" + outputFilename).c_str(), resultado.pixeles.data(), resultado.width,
+                               resultado.height, resultado.channels, opcionesSalida)) {
+                throw std::runtime_error("Error al guardar grafo_" + outputFilename);
+            }
+            std::cout << "[GRAFO] Imagen: " << resultado.width << "x" << resultado.height << " | Canales: " << resultado.channels << "\n";
+            std::cout << "Imagen guardada como: grafo_" << outputFilename << "\n";
+            return 0;
+        }
+
+        // ========== CACHE DE RESULTADOS ==========
+        // Las entradas de 16 bits y float se transforman sin pasar a 8 bits (ver abajo)
+        ProfundidadMuestra profundidad = profundidadImagen(inputFilename.c_str());
+        int bitsMuestra = profundidad == ProfundidadMuestra::Flotante ? 32 : (profundidad == ProfundidadMuestra::Bits16 ? 16 : 8);
+        std::string archivoConv, archivoBuddy, claveConv, claveBuddy;
+        FormatoImagen formatoSalida = resolverFormatoSalida("conv_" + outputFilename, opcionesSalida.formato, archivoConv);
+        resolverFormatoSalida("buddy_" + outputFilename, opcionesSalida.formato, archivoBuddy);
+        if (cacheResultados) {
+            std::string huella = CacheResultados::huellaEntrada(inputFilename);
+            claveConv = CacheResultados::calcularClave(huella, parametrosResultado("conv", bitsMuestra, angle, scaleFactor, fondo, interpolacion, formatoSalida, opcionesSalida));
+            if (usarBuddy) {
+                claveBuddy = CacheResultados::calcularClave(huella, parametrosResultado("buddy", bitsMuestra, angle, scaleFactor, fondo, interpolacion, formatoSalida, opcionesSalida));
+            }
+            // Con un acierto no hace falta decodificar, transformar ni codificar
+            if (cacheResultados->recuperar(claveConv, archivoConv) &&
+                (!usarBuddy || cacheResultados->recuperar(claveBuddy, archivoBuddy))) {
+                std::cout << "[CACHE] Resultado recuperado de " << directorioCache << "\n";
+                std::cout << "Imagen guardada como: " << archivoConv << "\n";
+                if (usarBuddy) std::cout << "Imagen guardada como: " << archivoBuddy << "\n";
+                return 0;
+            }
+        }
+
+        // ========== 16 BITS Y FLOAT ==========
+        // Las imagenes de 16 bits y HDR se transforman sin pasar a 8 bits; el PNG de
+        // salida conserva los 16 bits
+        auto transformarProfundo = [&](auto* original, int width, int height, int channels) {
+            using Muestra = typename std::remove_pointer<decltype(original)>::type;
+            int canalesRotada = canalesConFondo(channels, fondo);
+            auto ejecutarModo = [&](const char* etiqueta, const char* prefijo, AsignadorImagen& asignador,
+                                    const std::string& clave, const std::string& archivo) {
+                MedidorFase fase(std::string(etiqueta) + ": transformación");
+                auto inicio = std::chrono::high_resolution_clock::now();
+                int rotW, rotH, escW, escH;
+                Muestra* rotada = rotarImagen(original, width, height, channels, angle, asignador, rotW, rotH, fondo, interpolacion);
+                if (!rotada) throw std::runtime_error("Error al rotar la imagen");
+                Muestra* escalada = escalarImagen(rotada, rotW, rotH, canalesRotada, scaleFactor, asignador, escW, escH, interpolacion);
+                asignador.liberar(reinterpret_cast<unsigned char*>(rotada));
+                if (!escalada) throw std::runtime_error("Error al escalar la imagen");
+                auto fin = std::chrono::high_resolution_clock::now();
+                std::cout << "[" << etiqueta << "] Tiempo total: "
+                          << std::chrono::duration<double, std::milli>(fin - inicio).count() << " ms\n";
+                mostrarInformeFase(fase.terminar());
+
+                bool guardada = guardarImagen((prefijo + outputFilename).c_str(), escalada, escW, escH, canalesRotada, opcionesSalida);
+                asignador.liberar(reinterpret_cast<unsigned char*>(escalada));
+                // Solo se guarda en la cache lo que se acaba de escribir: si falló, en disco puede quedar un archivo viejo
+                if (!guardada) throw std::runtime_error("Error al guardar " + std::string(prefijo) + outputFilename);
+                if (cacheResultados) cacheResultados->almacenar(clave, archivo);
+                std::cout << "[" << etiqueta << "] Imagen escalada: " << escW << "x" << escH << "\n";
+                std::cout << "Imagen guardada como: " << prefijo << outputFilename << "\n\n";
+            };
+
+            std::cout << "=== MODO CONVENCIONAL ===\n";
+            AsignadorHeap heap;
+            ejecutarModo("CONVENCIONAL", "conv_", heap, claveConv, archivoConv);
+            if (usarBuddy) {
+                std::cout << "=== MODO BUDDY ===\n";
+                BuddySystem buddy(buddyMemory);
+                AsignadorBuddy asignadorBuddy(buddy);
+                ejecutarModo("BUDDY", "buddy_", asignadorBuddy, claveBuddy, archivoBuddy);
+            }
+            std::cout << "------------------------\n";
+        };
+
+        if (profundidad != ProfundidadMuestra::Bits8) {
+            MedidorFase faseCarga("Carga");
+            int width, height, channels;
+            bool flotante = profundidad == ProfundidadMuestra::Flotante;
+            void* original = flotante ? static_cast<void*>(cargarImagenFlotante(inputFilename.c_str(), width, height, channels))
+                                      : static_cast<void*>(cargarImagen16(inputFilename.c_str(), width, height, channels));
+            if (!original) throw std::runtime_error("Error al cargar la imagen");
+            mostrarInformeFase(faseCarga.terminar());
+            std::cout << "Dimensiones: " << width << "x" << height << " | Canales: " << channels
+                      << " | Muestras: " << (flotante ? "float" : "16 bits") << "\n\n";
+            if (flotante) {
+                transformarProfundo(static_cast<float*>(original), width, height, channels);
+            } else {
+                transformarProfundo(static_cast<uint16_t*>(original), width, height, channels);
+            }
+            stbi_image_free(original);
+            return 0;
+        }
+
+        MedidorFase faseCarga("Carga");
+        MedidorContadores contadoresCarga(contadores.get(), "Carga");
+        int width, height, channels;
+        unsigned char* originalImage = cargarImagen(inputFilename.c_str(), width, height, channels);
+        if (!originalImage) throw std::runtime_error("Error al cargar la imagen");
+        contadoresCarga.terminar();
+        mostrarInformeFase(faseCarga.terminar());
+
+        size_t inputSize = width * height * channels;
+        std::cout << "Dimensiones: " << width << "x" << height << " | Canales: " << channels << "\n\n";
+        // Con -fondo alfa la rotacion agrega un canal alfa a gris y RGB
+        int canalesRotada = canalesConFondo(channels, fondo);
+
+        // ========== MODO CONVENCIONAL ==========
+        std::cout << "=== MODO CONVENCIONAL ===\n";
+        MedidorFase faseConv("Convencional: transformación");
+        auto startConv = std::chrono::high_resolution_clock::now();
+
+        unsigned char* imageCopy;
+        {
+            TRAZA_TRAMO("copiar", "memoria");
+            imageCopy = new unsigned char[inputSize];
+            memcpy(imageCopy, originalImage, inputSize);
+        }
+
+        int rotW1, rotH1;
+        MedidorContadores contadoresRotarConv(contadores.get(), "Convencional: rotar");
+        AsignadorHeap heap;
+        unsigned char* rotadaConv = rotarImagen(imageCopy, width, height, channels, angle, heap, rotW1, rotH1, fondo, interpolacion);
+        contadoresRotarConv.terminar();
+        delete[] imageCopy;
+
+        int escW1, escH1;
+        MedidorContadores contadoresEscalarConv(contadores.get(), "Convencional: escalar");
+        unsigned char* escaladaConv = escalarImagen(rotadaConv, rotW1, rotH1, canalesRotada, scaleFactor, heap, escW1, escH1, interpolacion);
+        contadoresEscalarConv.terminar();
+        delete[] rotadaConv;
+
+        auto endConv = std::chrono::high_resolution_clock::now();
+        InformeFase memoriaConv = faseConv.terminar();
+        double tiempoConv = std::chrono::duration<double, std::milli>(endConv - startConv).count();
+
+        std::cout << "[CONVENCIONAL] Tiempo total: " << tiempoConv << " ms\n";
+        std::cout << "[CONVENCIONAL] Memoria estimada: " << ((rotW1 * rotH1 + escW1 * escH1) * canalesRotada) / 1024.0 << " KB\n";
+        std::cout << "[CONVENCIONAL] Memoria real usada: " << (memoriaConv.picoRssKB - memoriaConv.rssInicioKB) / 1024.0 << " MB\n";
+        mostrarInformeFase(memoriaConv);
+
+        MedidorFase faseGuardadoConv("Convencional: guardado");
+        MedidorContadores contadoresGuardadoConv(contadores.get(), "Convencional: guardado");
+        bool guardadaConv = guardarImagen(("conv_" + outputFilename).c_str(), escaladaConv, escW1, escH1, canalesRotada, opcionesSalida);
+        delete[] escaladaConv;
+        if (!guardadaConv) throw std::runtime_error("Error al guardar conv_" + outputFilename);
+        if (cacheResultados) cacheResultados->almacenar(claveConv, archivoConv);
+        contadoresGuardadoConv.terminar();
+        mostrarInformeFase(faseGuardadoConv.terminar());
+        std::cout << "[CONVENCIONAL] Imagen escalada: " << escW1 << "x" << escH1 << "\n";
+
+        std::cout << "Imagen guardada como: conv_" << outputFilename << "\n\n";
+
+        // ========== MODO BUDDY (si se activó el flag) ==========
+        if (usarBuddy) {
+            std::cout << "=== MODO BUDDY ===\n";
+            MedidorFase faseBuddy("Buddy: transformación");
+            auto startBuddy = std::chrono::high_resolution_clock::now();
+
+            BuddySystem buddy(buddyMemory);
+            unsigned char* imageBuddy = static_cast<unsigned char*>(buddy.allocate(inputSize));
+            if (!imageBuddy) throw std::runtime_error("No se pudo asignar memoria con Buddy");
+            {
+                TRAZA_TRAMO("copiar", "memoria");
+                memcpy(imageBuddy, originalImage, inputSize);
+            }
+
+            int rotW2, rotH2;
+            MedidorContadores contadoresRotarBuddy(contadores.get(), "Buddy: rotar");
+            AsignadorBuddy asignadorBuddy(buddy);
+            unsigned char* rotadaBuddy = rotarImagen(imageBuddy, width, height, channels, angle, asignadorBuddy, rotW2, rotH2, fondo, interpolacion);
+            contadoresRotarBuddy.terminar();
+            buddy.free(imageBuddy);
+
+            int escW2, escH2;
+            MedidorContadores contadoresEscalarBuddy(contadores.get(), "Buddy: escalar");
+            unsigned char* escaladaBuddy = escalarImagen(rotadaBuddy, rotW2, rotH2, canalesRotada, scaleFactor, asignadorBuddy, escW2, escH2, interpolacion);
+            contadoresEscalarBuddy.terminar();
+            buddy.free(rotadaBuddy);
+
+            auto endBuddy = std::chrono::high_resolution_clock::now();
+            InformeFase memoriaBuddy = faseBuddy.terminar();
+            double tiempoBuddy = std::chrono::duration<double, std::milli>(endBuddy - startBuddy).count();
+
+            std::cout << "[BUDDY] Tiempo total: " << tiempoBuddy << " ms\n";
+            std::cout << "[BUDDY] Memoria estimada: " << ((rotW2 * rotH2 + escW2 * escH2) * canalesRotada) / 1024.0 << " KB\n";
+            std::cout << "[BUDDY] Memoria real usada: " << (memoriaBuddy.picoRssKB - memoriaBuddy.rssInicioKB) / 1024.0 << " MB\n";
+            std::cout << "[BUDDY] Pico del Buddy System: " << buddy.picoMemoria() / 1024.0 << " KB | En uso: "
+                      << buddy.memoriaEnUso() / 1024.0 << " KB\n";
+            mostrarInformeFase(memoriaBuddy);
+
+            MedidorFase faseGuardadoBuddy("Buddy: guardado");
+            MedidorContadores contadoresGuardadoBuddy(contadores.get(), "Buddy: guardado");
+            bool guardadaBuddy = guardarImagen(("buddy_" + outputFilename).c_str(), escaladaBuddy, escW2, escH2, canalesRotada, opcionesSalida);
+            buddy.free(escaladaBuddy);
+            if (!guardadaBuddy) throw std::runtime_error("Error al guardar buddy_" + outputFilename);
+            if (cacheResultados) cacheResultados->almacenar(claveBuddy, archivoBuddy);
+            contadoresGuardadoBuddy.terminar();
+            mostrarInformeFase(faseGuardadoBuddy.terminar());
+            std::cout << "[BUDDY] Imagen escalada: " << escW2 << "x" << escH2 << "\n";
+
+            std::cout << "Imagen guardada como: buddy_" << outputFilename << "\n";
+        }
+
+        std::cout << "------------------------\n";
+        stbi_image_free(originalImage);
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "memoria.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <malloc.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<size_t> bytesVivos(0);
+std::atomic<size_t> picoBytes(0);
+std::atomic<size_t> totalAsignaciones(0);
+
+inline void registrarAsignacion(void* p) {
+    size_t n = malloc_usable_size(p);
+    size_t vivos = bytesVivos.fetch_add(n, std::memory_order_relaxed) + n;
+    totalAsignaciones.fetch_add(1, std::memory_order_relaxed);
+    size_t pico = picoBytes.load(std::memory_order_relaxed);
+    while (vivos > pico && !picoBytes.compare_exchange_weak(pico, vivos, std::memory_order_relaxed)) {
+    }
+}
+
+inline void registrarLiberacion(void* p) {
+    bytesVivos.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+}
+
+void* asignar(size_t n, size_t alineacion, bool lanzar) {
+    if (n == 0) n = 1;
+    void* p;
+    for (;;) {
+        if (alineacion <= alignof(std::max_align_t)) {
+            p = malloc(n);
+        } else {
+            p = aligned_alloc(alineacion, (n + alineacion - 1) / alineacion * alineacion);
+        }
+        if (p) break;
+        std::new_handler manejador = std::get_new_handler();
+        if (!manejador) {
+            if (lanzar) throw std::bad_alloc();
+            return nullptr;
+        }
+        manejador();
+    }
+    registrarAsignacion(p);
+    return p;
+}
+
+void liberar(void* p) {
+    if (!p) return;
+    registrarLiberacion(p);
+    free(p);
+}
+
+// Busca "clave:  valor kB" en /proc/self/status
+size_t leerCampoStatus(const char* clave) {
+    FILE* archivo = fopen("/proc/self/status", "r");
+    if (!archivo) return 0;
+    char linea[256];
+    size_t valor = 0;
+    size_t largo = strlen(clave);
+    while (fgets(linea, sizeof(linea), archivo)) {
+        if (strncmp(linea, clave, largo) == 0 && linea[largo] == ':') {
+            valor = strtoull(linea + largo + 1, nullptr, 10);
+            break;
+        }
+    }
+    fclose(archivo);
+    return valor;
+}
+
+} // namespace
+
+// Reemplazo del operator new/delete global para contar la memoria del heap
+void* operator new(size_t n) { return asignar(n, 0, true); }
+void* operator new[](size_t n) { return asignar(n, 0, true); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return asignar(n, 0, false); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return asignar(n, 0, false); }
+void* operator new(size_t n, std::align_val_t a) { return asignar(n, static_cast<size_t>(a), true); }
+void* operator new[](size_t n, std::align_val_t a) { return asignar(n, static_cast<size_t>(a), true); }
+void* operator new(size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return asignar(n, static_cast<size_t>(a), false); }
+void* operator new[](size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return asignar(n, static_cast<size_t>(a), false); }
+void operator delete(void* p) noexcept { liberar(p); }
+void operator delete[](void* p) noexcept { liberar(p); }
+void operator delete(void* p, size_t) noexcept { liberar(p); }
+void operator delete[](void* p, size_t) noexcept { liberar(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete(void* p, std::align_val_t) noexcept { liberar(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { liberar(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { liberar(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { liberar(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { liberar(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { liberar(p); }
+
+EstadisticasHeap estadisticasHeap() {
+    EstadisticasHeap stats;
+    stats.vivos = bytesVivos.load(std::memory_order_relaxed);
+    stats.pico = picoBytes.load(std::memory_order_relaxed);
+    stats.asignaciones = totalAsignaciones.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void reiniciarPicoHeap() {
+    picoBytes.store(bytesVivos.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+size_t memoriaResidenteKB() {
+    FILE* archivo = fopen("/proc/self/statm", "r");
+    if (!archivo) return 0;
+    unsigned long long total = 0, residente = 0;
+    int leidos = fscanf(archivo, "%llu %llu", &total, &residente);
+    fclose(archivo);
+    if (leidos != 2) return 0;
+    return static_cast<size_t>(residente) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+}
+
+size_t picoResidenteKB() {
+    return leerCampoStatus("VmHWM");
+}
+
+bool reiniciarPicoResidente() {
+    FILE* archivo = fopen("/proc/self/clear_refs", "w");
+    if (!archivo) return false;
+    bool ok = fputs("5", archivo) >= 0;
+    return (fclose(archivo) == 0) && ok;
+}
+
+MedidorFase::MedidorFase(const std::string& nombre) {
+    informe.nombre = nombre;
+    informe.picoRssExacto = reiniciarPicoResidente();
+    informe.rssInicioKB = memoriaResidenteKB();
+    reiniciarPicoHeap();
+    EstadisticasHeap heap = estadisticasHeap();
+    informe.heapInicio = heap.vivos;
+    asignacionesInicio = heap.asignaciones;
+}
+
+InformeFase MedidorFase::terminar() {
+    EstadisticasHeap heap = estadisticasHeap();
+    informe.heapFin = heap.vivos;
+    informe.picoHeap = heap.pico;
+    informe.asignaciones = heap.asignaciones - asignacionesInicio;
+    informe.rssFinKB = memoriaResidenteKB();
+    informe.picoRssKB = std::max(informe.rssInicioKB, informe.rssFinKB);
+    if (informe.picoRssExacto) {
+        informe.picoRssKB = std::max(informe.picoRssKB, picoResidenteKB());
+    }
+    return informe;
+}
+
+void mostrarInformeFase(const InformeFase& informe) {
+    std::cout << "[MEMORIA] " << informe.nombre
+              << " | RSS: " << informe.rssInicioKB / 1024.0 << " -> " << informe.rssFinKB / 1024.0 << " MB"
+              << " | Pico RSS: " << informe.picoRssKB / 1024.0 << " MB" << (informe.picoRssExacto ? "" : " (aprox.)")
+              << " | Heap: " << informe.heapInicio / 1024.0 << " -> " << informe.heapFin / 1024.0 << " KB"
+              << " | Pico heap: " << informe.picoHeap / 1024.0 << " KB"
+              << " | Asignaciones: " << informe.asignaciones << "\n";
+}
@@ -0,0 +1,229 @@
+#include "planificador.h"
+#include "traza.h"
+#include <string>
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+
+thread_local Planificador* planificadorActual = nullptr;
+thread_local int indiceActual = -1;
+
+std::unique_ptr<Planificador>& instanciaGlobal() {
+    static std::unique_ptr<Planificador> instancia;
+    return instancia;
+}
+
+} // namespace
+
+Planificador::Planificador(int hilos, bool fijarNucleos) : pendientes(0), detener(false) {
+    if (hilos <= 0) {
+        hilos = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    int numTrabajadores = std::max(0, hilos - 1);
+    for (int i = 0; i < numTrabajadores; ++i) {
+        colas.emplace_back(new ColaTrabajador());
+    }
+    for (int i = 0; i < numTrabajadores; ++i) {
+        trabajadores.emplace_back(&Planificador::bucleTrabajador, this, i, fijarNucleos);
+    }
+}
+
+Planificador::~Planificador() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexSueno);
+        detener = true;
+    }
+    despertar.notify_all();
+    for (auto& t : trabajadores) {
+        t.join();
+    }
+}
+
+Planificador& Planificador::global() {
+    std::unique_ptr<Planificador>& instancia = instanciaGlobal();
+    if (!instancia) {
+        instancia.reset(new Planificador());
+    }
+    return *instancia;
+}
+
+void Planificador::configurar(int hilos, bool fijarNucleos) {
+    std::unique_ptr<Planificador>& instancia = instanciaGlobal();
+    instancia.reset();
+    instancia.reset(new Planificador(hilos, fijarNucleos));
+}
+
+bool Planificador::tomarTarea(int indice, Tarea& tarea) {
+    // 1) Final de la cola propia (lo ultimo que se envio sigue en cache)
+    if (indice >= 0) {
+        ColaTrabajador& propia = *colas[indice];
+        std::lock_guard<std::mutex> bloqueo(propia.mutex);
+        if (!propia.tareas.empty()) {
+            tarea = std::move(propia.tareas.back());
+            propia.tareas.pop_back();
+            return true;
+        }
+    }
+    // 2) Tareas que llegaron desde fuera del planificador
+    {
+        std::lock_guard<std::mutex> bloqueo(inyeccion.mutex);
+        if (!inyeccion.tareas.empty()) {
+            tarea = std::move(inyeccion.tareas.front());
+            inyeccion.tareas.pop_front();
+            return true;
+        }
+    }
+    // 3) Robar del principio de la cola de otro trabajador
+    int n = static_cast<int>(colas.size());
+    for (int k = 1; k <= n; ++k) {
+        int victima = (indice + k + n) % n;
+        if (victima == indice) continue;
+        ColaTrabajador& otra = *colas[victima];
+        std::lock_guard<std::mutex> bloqueo(otra.mutex);
+        if (!otra.tareas.empty()) {
+            tarea = std::move(otra.tareas.front());
+            otra.tareas.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Planificador::bucleTrabajador(int indice, bool fijarNucleo) {
+    planificadorActual = this;
+    indiceActual = indice;
+
+    if (fijarNucleo) {
+        int nucleos = static_cast<int>(std::thread::hardware_concurrency());
+        if (nucleos > 0) {
+            // El hilo principal queda en el nucleo 0; los trabajadores desde el 1
+            cpu_set_t conjunto;
+            CPU_ZERO(&conjunto);
+            CPU_SET((indice + 1) % nucleos, &conjunto);
+            pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto);
+        }
+    }
+
+    if (trazaHabilitada.load(std::memory_order_relaxed)) {
+        nombrarHiloTraza(("trabajador " + std::to_string(indice)).c_str());
+    }
+
+    for (;;) {
+        Tarea tarea;
+        if (tomarTarea(indice, tarea)) {
+            --pendientes;
+            TRAZA_TRAMO("tarea", "planificador");
+            tarea();
+            continue;
+        }
+        std::unique_lock<std::mutex> bloqueo(mutexSueno);
+        despertar.wait(bloqueo, [this]() { return detener || pendientes.load() > 0; });
+        if (detener && pendientes.load() == 0) {
+            return;
+        }
+    }
+}
+
+void Planificador::ejecutar(Tarea tarea) {
+    if (trabajadores.empty()) {
+        tarea();   // Un solo hilo: no hay con quien repartir
+        return;
+    }
+    if (planificadorActual == this && indiceActual >= 0) {
+        ColaTrabajador& propia = *colas[indiceActual];
+        std::lock_guard<std::mutex> bloqueo(propia.mutex);
+        propia.tareas.push_back(std::move(tarea));
+    } else {
+        std::lock_guard<std::mutex> bloqueo(inyeccion.mutex);
+        inyeccion.tareas.push_back(std::move(tarea));
+    }
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexSueno);
+        ++pendientes;
+    }
+    despertar.notify_one();
+}
+
+bool Planificador::ejecutarUna() {
+    Tarea tarea;
+    int indice = (planificadorActual == this) ? indiceActual : -1;
+    if (!tomarTarea(indice, tarea)) {
+        return false;
+    }
+    --pendientes;
+    TRAZA_TRAMO("tarea", "planificador");
+    tarea();
+    return true;
+}
+
+void Planificador::paraCada(int inicio, int fin, int grano, const std::function<void(int, int)>& cuerpo) {
+    if (fin <= inicio) return;
+    grano = std::max(1, grano);
+    if (trabajadores.empty() || fin - inicio <= grano) {
+        cuerpo(inicio, fin);
+        return;
+    }
+    GrupoTareas grupo(*this);
+    for (int a = inicio; a < fin; a += grano) {
+        int b = std::min(fin, a + grano);
+        grupo.ejecutar([&cuerpo, a, b]() { cuerpo(a, b); });
+    }
+    grupo.esperar();
+}
+
+void Planificador::paraCada2D(int ancho, int alto, int bloqueAncho, int bloqueAlto,
+                              const std::function<void(int, int, int, int)>& cuerpo) {
+    if (ancho <= 0 || alto <= 0) return;
+    bloqueAncho = std::max(1, bloqueAncho);
+    bloqueAlto = std::max(1, bloqueAlto);
+    if (trabajadores.empty()) {
+        cuerpo(0, 0, ancho, alto);
+        return;
+    }
+    GrupoTareas grupo(*this);
+    for (int y = 0; y < alto; y += bloqueAlto) {
+        for (int x = 0; x < ancho; x += bloqueAncho) {
+            int x1 = std::min(ancho, x + bloqueAncho);
+            int y1 = std::min(alto, y + bloqueAlto);
+            grupo.ejecutar([&cuerpo, x, y, x1, y1]() { cuerpo(x, y, x1, y1); });
+        }
+    }
+    grupo.esperar();
+}
+
+GrupoTareas::GrupoTareas(Planificador& planificador) : planificador(planificador), pendientes(0) {}
+
+GrupoTareas::~GrupoTareas() {
+    // Las tareas referencian al grupo: nunca destruirlo con tareas en vuelo
+    while (pendientes.load() > 0) {
+        if (!planificador.ejecutarUna()) std::this_thread::yield();
+    }
+}
+
+void GrupoTareas::ejecutar(Tarea tarea) {
+    ++pendientes;
+    planificador.ejecutar([this, tarea = std::move(tarea)]() {
+        try {
+            tarea();
+        } catch (...) {
+            std::lock_guard<std::mutex> bloqueo(mutexError);
+            if (!error) error = std::current_exception();
+        }
+        --pendientes;
+    });
+}
+
+void GrupoTareas::esperar() {
+    while (pendientes.load() > 0) {
+        if (!planificador.ejecutarUna()) {
+            std::this_thread::yield();
+        }
+    }
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
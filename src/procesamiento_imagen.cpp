@@ -1,155 +1,246 @@
-#include "procesamiento_imagen.h"
-#include "stb_image.h"
-#include "stb_image_write.h"
-#include <iostream>
-#include <string>
-#include <cstring>
-#include <algorithm>
-#include <cmath>  // Necesario para floor() y round()
-
-unsigned char* cargarImagen(const char* filename, int& width, int& height, int& channels) {
-    return stbi_load(filename, &width, &height, &channels, 0);
-}
-
-bool guardarImagen(const char* filename, unsigned char* image, int width, int height, int channels) {
-    if (!image || width <= 0 || height <= 0 || channels <= 0) {
-        std::cerr << "Error: Parámetros inválidos para guardar imagen\n";
-        return false;
-    }
-    
-    std::string fn(filename);
-    if (fn.find(".png") == std::string::npos) {
-        fn += ".png";
-    }
-    
-    int result = stbi_write_png(fn.c_str(), width, height, channels, image, width * channels);
-    if (!result) {
-        std::cerr << "Error al guardar la imagen en " << fn << "\n";
-        return false;
-    }
-    
-    return true;
-}
-
-unsigned char bilinearInterpolation(float x, float y, unsigned char* img, int width, int height, int channels, int channel) {
-    int x1 = std::floor(x);  // Usar std::floor
-    int x2 = std::min(x1 + 1, width - 1);
-    int y1 = std::floor(y);  // Usar std::floor
-    int y2 = std::min(y1 + 1, height - 1);
-
-    float dx = x - x1;
-    float dy = y - y1;
-
-    int idx11 = (y1 * width + x1) * channels + channel;
-    int idx12 = (y2 * width + x1) * channels + channel;
-    int idx21 = (y1 * width + x2) * channels + channel;
-    int idx22 = (y2 * width + x2) * channels + channel;
-
-    float value = (1 - dx) * (1 - dy) * img[idx11] +
-                 (1 - dx) * dy * img[idx12] +
-                 dx * (1 - dy) * img[idx21] +
-                 dx * dy * img[idx22];
-
-    return static_cast<unsigned char>(std::round(value));  // Usar std::round
-}
-
-unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, BuddySystem& buddy, int& newWidth, int& newHeight) {
-    newWidth = static_cast<int>(std::round(width * scaleFactor));  // Usar std::round
-    newHeight = static_cast<int>(std::round(height * scaleFactor));  // Usar std::round
-
-    unsigned char* scaledImage = static_cast<unsigned char*>(buddy.allocate(newWidth * newHeight * channels));
-    if (!scaledImage) {
-        return nullptr;
-    }
-
-    for (int y = 0; y < newHeight; ++y) {
-        for (int x = 0; x < newWidth; ++x) {
-            float srcX = x / scaleFactor;
-            float srcY = y / scaleFactor;
-
-            for (int c = 0; c < channels; ++c) {
-                scaledImage[(y * newWidth + x) * channels + c] =
-                    bilinearInterpolation(srcX, srcY, image, width, height, channels, c);
-            }
-        }
-    }
-
-    return scaledImage;
-}
-
-// Sin BuddySystem
-
-#include <cmath>
-
-unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, int& newWidth, int& newHeight) {
-    float radians = angle * M_PI / 180.0f;
-
-    // Cálculo del tamaño de la nueva imagen
-    float cosA = std::cos(radians);
-    float sinA = std::sin(radians);
-    newWidth = static_cast<int>(std::abs(width * cosA) + std::abs(height * sinA));
-    newHeight = static_cast<int>(std::abs(width * sinA) + std::abs(height * cosA));
-
-    unsigned char* rotatedImage = new unsigned char[newWidth * newHeight * channels];
-
-    // Fondo negro (opcional)
-    std::memset(rotatedImage, 0, newWidth * newHeight * channels);
-
-    // Centro de la imagen original y rotada
-    float cx = width / 2.0f;
-    float cy = height / 2.0f;
-    float ncx = newWidth / 2.0f;
-    float ncy = newHeight / 2.0f;
-
-    for (int y = 0; y < newHeight; ++y) {
-        for (int x = 0; x < newWidth; ++x) {
-            // Coordenadas relativas al centro de la nueva imagen
-            float rx = x - ncx;
-            float ry = y - ncy;
-
-            // Aplicar rotación inversa
-            float origX = cosA * rx + sinA * ry + cx;
-            float origY = -sinA * rx + cosA * ry + cy;
-
-            // Redondear a coordenadas de pixel válidas
-            int srcX = static_cast<int>(std::round(origX));
-            int srcY = static_cast<int>(std::round(origY));
-
-            if (srcX >= 0 && srcX < width && srcY >= 0 && srcY < height) {
-                int origIndex = (srcY * width + srcX) * channels;
-                int newIndex = (y * newWidth + x) * channels;
-
-                for (int c = 0; c < channels; ++c) {
-                    rotatedImage[newIndex + c] = image[origIndex + c];
-                }
-            }
-        }
-    }
-
-    return rotatedImage;
-}
-
-unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, int& newWidth, int& newHeight) {
-    newWidth = static_cast<int>(width * scaleFactor);
-    newHeight = static_cast<int>(height * scaleFactor);
-
-    unsigned char* newImage = new unsigned char[newWidth * newHeight * channels];
-
-    for (int y = 0; y < newHeight; ++y) {
-        for (int x = 0; x < newWidth; ++x) {
-            int origX = static_cast<int>(x / scaleFactor);
-            int origY = static_cast<int>(y / scaleFactor);
-
-            int origIndex = (origY * width + origX) * channels;
-            int newIndex = (y * newWidth + x) * channels;
-
-            for (int c = 0; c < channels; ++c) {
-                newImage[newIndex + c] = image[origIndex + c];
-            }
-        }
-    }
-
-    return newImage;
-}
-
-
+#include "procesamiento_imagen.h"
+#include "archivo_mapeado.h"
+#include "motor_transformacion.h"
+#include "traza.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <climits>
+#include <cctype>
+#include <cmath>  // Necesario para floor() y round()
+
+unsigned char* cargarImagen(const char* filename, int& width, int& height, int& channels) {
+    TRAZA_TRAMO("cargar", "carga");
+    // Decodificar directamente desde la proyección del archivo; si no se puede
+    // proyectar (tubería, archivo vacío...) se vuelve a la lectura con stdio
+    ArchivoMapeado archivo;
+    if (archivo.abrir(filename) && archivo.size() <= static_cast<size_t>(INT_MAX)) {
+        return stbi_load_from_memory(archivo.data(), static_cast<int>(archivo.size()), &width, &height, &channels, 0);
+    }
+    return stbi_load(filename, &width, &height, &channels, 0);
+}
+
+ProfundidadMuestra profundidadImagen(const char* filename) {
+    ArchivoMapeado archivo;
+    bool hdr, bits16;
+    if (archivo.abrir(filename) && archivo.size() <= static_cast<size_t>(INT_MAX)) {
+        int n = static_cast<int>(archivo.size());
+        hdr = stbi_is_hdr_from_memory(archivo.data(), n) != 0;
+        bits16 = stbi_is_16_bit_from_memory(archivo.data(), n) != 0;
+    } else {
+        hdr = stbi_is_hdr(filename) != 0;
+        bits16 = stbi_is_16_bit(filename) != 0;
+    }
+    if (hdr) return ProfundidadMuestra::Flotante;
+    return bits16 ? ProfundidadMuestra::Bits16 : ProfundidadMuestra::Bits8;
+}
+
+uint16_t* cargarImagen16(const char* filename, int& width, int& height, int& channels) {
+    TRAZA_TRAMO("cargar", "carga");
+    ArchivoMapeado archivo;
+    if (archivo.abrir(filename) && archivo.size() <= static_cast<size_t>(INT_MAX)) {
+        return stbi_load_16_from_memory(archivo.data(), static_cast<int>(archivo.size()), &width, &height, &channels, 0);
+    }
+    return stbi_load_16(filename, &width, &height, &channels, 0);
+}
+
+float* cargarImagenFlotante(const char* filename, int& width, int& height, int& channels) {
+    TRAZA_TRAMO("cargar", "carga");
+    ArchivoMapeado archivo;
+    if (archivo.abrir(filename) && archivo.size() <= static_cast<size_t>(INT_MAX)) {
+        return stbi_loadf_from_memory(archivo.data(), static_cast<int>(archivo.size()), &width, &height, &channels, 0);
+    }
+    return stbi_loadf(filename, &width, &height, &channels, 0);
+}
+
+namespace {
+
+// Lee la cabecera de un PNM binario (P5/P6) con 8 bits por muestra
+bool leerCabeceraPNM(const unsigned char* datos, size_t n, int& width, int& height, int& channels, size_t& inicio) {
+    if (n < 3 || datos[0] != 'P' || (datos[1] != '5' && datos[1] != '6')) return false;
+    channels = datos[1] == '5' ? 1 : 3;
+    size_t p = 2;
+    int valores[3];
+    for (int& v : valores) {
+        while (p < n && (std::isspace(datos[p]) || datos[p] == '#')) {
+            if (datos[p] == '#') {
+                while (p < n && datos[p] != '\n') ++p;
+            } else {
+                ++p;
+            }
+        }
+        if (p >= n || !std::isdigit(datos[p])) return false;
+        v = 0;
+        while (p < n && std::isdigit(datos[p])) {
+            // El archivo no es de confianza: un numero que no cabe en int es una cabecera invalida
+            if (v > (INT_MAX - 9) / 10) return false;
+            v = v * 10 + (datos[p++] - '0');
+        }
+    }
+    width = valores[0];
+    height = valores[1];
+    inicio = p + 1;   // Un solo espacio separa la cabecera de los datos
+    return valores[2] == 255 && width > 0 && height > 0 &&
+           inicio + static_cast<size_t>(width) * height * channels <= n;
+}
+
+} // namespace
+
+unsigned char* cargarRegionImagen(const char* filename, int x, int y, int regionWidth, int regionHeight,
+                                  int& width, int& height, int& channels) {
+    if (regionWidth <= 0 || regionHeight <= 0 || x < 0 || y < 0) return nullptr;
+
+    ArchivoMapeado archivo;
+    size_t inicio = 0;
+    const unsigned char* pixeles = nullptr;
+    unsigned char* decodificada = nullptr;
+    if (archivo.abrir(filename, false) && leerCabeceraPNM(archivo.data(), archivo.size(), width, height, channels, inicio)) {
+        // Solo se tocan las páginas de las filas pedidas
+        pixeles = archivo.data() + inicio;
+    } else {
+        decodificada = cargarImagen(filename, width, height, channels);
+        pixeles = decodificada;
+    }
+    if (!pixeles || x + regionWidth > width || y + regionHeight > height) {
+        if (decodificada) stbi_image_free(decodificada);
+        return nullptr;
+    }
+
+    size_t bytesFila = static_cast<size_t>(regionWidth) * channels;
+    unsigned char* region = new unsigned char[bytesFila * regionHeight];
+    for (int fila = 0; fila < regionHeight; ++fila) {
+        memcpy(region + fila * bytesFila,
+               pixeles + ((static_cast<size_t>(y) + fila) * width + x) * channels, bytesFila);
+    }
+    if (decodificada) stbi_image_free(decodificada);
+    return region;
+}
+
+bool guardarImagen(const char* filename, unsigned char* image, int width, int height, int channels) {
+    return guardarImagen(filename, image, width, height, channels, OpcionesGuardado());
+}
+
+bool guardarImagen(const char* filename, unsigned char* image, int width, int height, int channels, const OpcionesGuardado& opciones) {
+    TRAZA_TRAMO("guardar", "codificacion");
+    if (!image || width <= 0 || height <= 0 || channels <= 0) {
+        std::cerr << "Error: Parámetros inválidos para guardar imagen\n";
+        return false;
+    }
+    
+    // El formato sale de la extensión salvo que se fuerce; si no coinciden se agrega la extensión
+    std::string fn;
+    FormatoImagen formato = resolverFormatoSalida(filename, opciones.formato, fn);
+    
+    if (!guardarImagenFormato(fn.c_str(), image, width, height, channels, formato, opciones)) {
+        std::cerr << "Error al guardar la imagen en " << fn << "\n";
+        return false;
+    }
+    
+    return true;
+}
+
+bool guardarImagen(const char* filename, const uint16_t* image, int width, int height, int channels, const OpcionesGuardado& opciones) {
+    TRAZA_TRAMO("guardar", "codificacion");
+    if (!image || width <= 0 || height <= 0 || channels <= 0) {
+        std::cerr << "Error: Parámetros inválidos para guardar imagen\n";
+        return false;
+    }
+    std::string fn;
+    FormatoImagen formato = resolverFormatoSalida(filename, opciones.formato, fn);
+    if (!guardarImagenFormato16(fn.c_str(), image, width, height, channels, formato, opciones)) {
+        std::cerr << "Error al guardar la imagen en " << fn << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool guardarImagen(const char* filename, const float* image, int width, int height, int channels, const OpcionesGuardado& opciones) {
+    TRAZA_TRAMO("guardar", "codificacion");
+    if (!image || width <= 0 || height <= 0 || channels <= 0) {
+        std::cerr << "Error: Parámetros inválidos para guardar imagen\n";
+        return false;
+    }
+    std::string fn;
+    FormatoImagen formato = resolverFormatoSalida(filename, opciones.formato, fn);
+    if (!guardarImagenFormatoFlotante(fn.c_str(), image, width, height, channels, formato, opciones)) {
+        std::cerr << "Error al guardar la imagen en " << fn << "\n";
+        return false;
+    }
+    return true;
+}
+
+unsigned char bilinearInterpolation(float x, float y, unsigned char* img, int width, int height, int channels, int channel) {
+    if (channels < 1 || channels > 4 || channel < 0 || channel >= channels) return 0;
+    // Mismo muestreo que el motor, incluida la ponderacion por alfa de gris+alfa y RGBA;
+    // el ultimo pixel de cada fila y columna se repite como vecino
+    unsigned char px[4];
+    InterpolacionBilineal::muestrearDentro<false>(const_cast<const unsigned char*>(img), 0, 0, width, height, width,
+                                                  channels, x, y, px);
+    return px[channel];
+}
+
+namespace {
+
+// Igual para 8 bits, 16 bits y float
+template <typename T>
+T* escalarMuestras(const T* image, int width, int height, int channels, float scaleFactor, AsignadorImagen& asignador,
+                   int& newWidth, int& newHeight, Interpolacion interpolacion) {
+    TRAZA_TRAMO("escalar", "kernel");
+    MatrizAfin directa = matrizEscalaImagen(width, height, scaleFactor, newWidth, newHeight);
+    return conInterpolacion(interpolacion, [&](auto politica) {
+        return transformarImagen<decltype(politica)>(image, width, height, channels, directa.inversa(),
+                                                     newWidth, newHeight, asignador);
+    });
+}
+
+} // namespace
+
+unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, AsignadorImagen& asignador, int& newWidth, int& newHeight,
+                             Interpolacion interpolacion) {
+    return escalarMuestras(const_cast<const unsigned char*>(image), width, height, channels, scaleFactor, asignador,
+                           newWidth, newHeight, interpolacion);
+}
+
+uint16_t* escalarImagen(const uint16_t* image, int width, int height, int channels, float scaleFactor,
+                        AsignadorImagen& asignador, int& newWidth, int& newHeight, Interpolacion interpolacion) {
+    return escalarMuestras(image, width, height, channels, scaleFactor, asignador, newWidth, newHeight, interpolacion);
+}
+
+float* escalarImagen(const float* image, int width, int height, int channels, float scaleFactor,
+                     AsignadorImagen& asignador, int& newWidth, int& newHeight, Interpolacion interpolacion) {
+    return escalarMuestras(image, width, height, channels, scaleFactor, asignador, newWidth, newHeight, interpolacion);
+}
+
+void calcularTamanoEscalado(int width, int height, float scaleFactor, int& newWidth, int& newHeight) {
+    matrizEscalaImagen(width, height, scaleFactor, newWidth, newHeight);
+}
+
+bool escalarImagenEn(const unsigned char* image, int width, int height, int channels, float scaleFactor,
+                     unsigned char* destino, int newWidth, int newHeight, size_t pasoDestino,
+                     Interpolacion interpolacion) {
+    TRAZA_TRAMO("escalar", "kernel");
+    int esperadoAncho = 0, esperadoAlto = 0;
+    MatrizAfin directa = matrizEscalaImagen(width, height, scaleFactor, esperadoAncho, esperadoAlto);
+    if (newWidth != esperadoAncho || newHeight != esperadoAlto) {
+        std::cerr << "Error: El destino del escalado debe medir " << esperadoAncho << "x" << esperadoAlto
+                  << " (recibido " << newWidth << "x" << newHeight << ")\n";
+        return false;
+    }
+    return conInterpolacion(interpolacion, [&](auto politica) {
+        return transformarImagenEn<decltype(politica)>(image, width, height, channels, directa.inversa(),
+                                                       destino, newWidth, newHeight, pasoDestino);
+    });
+}
+
+unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, BuddySystem& buddy, int& newWidth, int& newHeight) {
+    AsignadorBuddy asignador(buddy);
+    return escalarImagen(image, width, height, channels, scaleFactor, asignador, newWidth, newHeight);
+}
+
+unsigned char* escalarImagen(unsigned char* image, int width, int height, int channels, float scaleFactor, int& newWidth, int& newHeight) {
+    AsignadorHeap asignador;
+    return escalarImagen(image, width, height, channels, scaleFactor, asignador, newWidth, newHeight);
+}
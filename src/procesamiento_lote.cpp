@@ -0,0 +1,343 @@
+#include "procesamiento_lote.h"
+#include "procesamiento_imagen.h"
+#include "buddy_system.h"
+#include "asignadores.h"
+#include "cola_acotada.h"
+#include "traza.h"
+#include "stb_image.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cctype>
+#include <glob.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace {
+
+bool esDirectorio(const std::string& ruta) {
+    struct stat info;
+    return stat(ruta.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+bool tieneExtensionImagen(const std::string& nombre) {
+    static const char* extensiones[] = {"jpg", "jpeg", "png", "bmp", "tga", "ppm", "pgm", "gif", "psd", "hdr", "pic"};
+    size_t punto = nombre.find_last_of('.');
+    if (punto == std::string::npos) return false;
+    std::string ext = nombre.substr(punto + 1);
+    for (char& ch : ext) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    for (const char* e : extensiones) {
+        if (ext == e) return true;
+    }
+    return false;
+}
+
+void reemplazarTodo(std::string& texto, const std::string& marcador, const std::string& valor) {
+    for (size_t p = texto.find(marcador); p != std::string::npos; p = texto.find(marcador, p + valor.size())) {
+        texto.replace(p, marcador.size(), valor);
+    }
+}
+
+// Buddy System propio de un hilo de transformacion. El mutex permite que la
+// etapa de codificacion libere los buffers que ese hilo asigno.
+struct BuddyTrabajador {
+    BuddySystem buddy;
+    std::mutex mutex;
+    explicit BuddyTrabajador(size_t memoria) : buddy(memoria) {}
+};
+
+struct TrabajoLote {
+    size_t indice = 0;
+    unsigned char* pixeles = nullptr;
+    int width = 0, height = 0, channels = 0;
+    BuddyTrabajador* duenio = nullptr;   // nullptr: memoria de stb, del pool o new[]
+    PoolBuffers* pool = nullptr;
+    bool transformada = false;
+    std::string clave;                   // Clave en la cache de resultados (vacia si no hay cache)
+};
+
+// Si la salida de esta entrada ya esta en la cache la copia y devuelve true
+bool recuperarDeCache(const std::vector<std::string>& entradas, TrabajoLote& trabajo, const OpcionesLote& opciones) {
+    if (!opciones.cache) return false;
+    const std::string& entrada = entradas[trabajo.indice];
+    std::string salida;
+    FormatoImagen formato = resolverFormatoSalida(aplicarPlantilla(opciones.plantilla, entrada, trabajo.indice),
+                                                  opciones.salida.formato, salida);
+    trabajo.clave = CacheResultados::calcularClave(
+        CacheResultados::huellaEntrada(entrada),
+        parametrosResultado(opciones.usarBuddy ? "buddy" : "conv", 8, opciones.angle, opciones.scaleFactor, opciones.fondo,
+                            opciones.interpolacion, formato, opciones.salida));
+    if (!opciones.cache->recuperar(trabajo.clave, salida)) return false;
+    std::cout << ("[LOTE] " + entrada + " -> " + salida + " (cache)\n");
+    return true;
+}
+
+bool decodificar(const std::vector<std::string>& entradas, TrabajoLote& trabajo) {
+    trabajo.pixeles = cargarImagen(entradas[trabajo.indice].c_str(), trabajo.width, trabajo.height, trabajo.channels);
+    if (!trabajo.pixeles) {
+        std::cerr << "[LOTE] No se pudo cargar " << entradas[trabajo.indice] << "\n";
+        return false;
+    }
+    return true;
+}
+
+void liberar(TrabajoLote& trabajo) {
+    if (!trabajo.pixeles) return;
+    if (!trabajo.transformada) {
+        stbi_image_free(trabajo.pixeles);
+    } else if (trabajo.duenio) {
+        std::lock_guard<std::mutex> bloqueo(trabajo.duenio->mutex);
+        trabajo.duenio->buddy.free(trabajo.pixeles);
+    } else if (trabajo.pool) {
+        trabajo.pool->liberar(trabajo.pixeles);
+    } else {
+        delete[] trabajo.pixeles;
+    }
+    trabajo.pixeles = nullptr;
+}
+
+// Rota y escala; reemplaza los pixeles del trabajo por el resultado
+bool transformar(TrabajoLote& trabajo, BuddyTrabajador* buddy, PoolBuffers* pool, const OpcionesLote& opciones) {
+    int rotW, rotH, escW, escH;
+    int canales = canalesConFondo(trabajo.channels, opciones.fondo);
+    unsigned char* escalada;
+    if (buddy) {
+        std::lock_guard<std::mutex> bloqueo(buddy->mutex);
+        AsignadorBuddy asignador(buddy->buddy);
+        unsigned char* rotada = rotarImagen(trabajo.pixeles, trabajo.width, trabajo.height, trabajo.channels,
+                                            opciones.angle, asignador, rotW, rotH, opciones.fondo, opciones.interpolacion);
+        escalada = rotada ? escalarImagen(rotada, rotW, rotH, canales, opciones.scaleFactor, asignador, escW, escH,
+                                          opciones.interpolacion) : nullptr;
+        if (rotada) buddy->buddy.free(rotada);
+    } else {
+        AsignadorHeap heap;
+        AsignadorImagen& asignador = pool ? static_cast<AsignadorImagen&>(*pool) : heap;
+        unsigned char* rotada = rotarImagen(trabajo.pixeles, trabajo.width, trabajo.height, trabajo.channels,
+                                            opciones.angle, asignador, rotW, rotH, opciones.fondo, opciones.interpolacion);
+        escalada = rotada ? escalarImagen(rotada, rotW, rotH, canales, opciones.scaleFactor, asignador, escW, escH,
+                                          opciones.interpolacion) : nullptr;
+        asignador.liberar(rotada);
+    }
+
+    liberar(trabajo);
+    if (!escalada) return false;
+    trabajo.pixeles = escalada;
+    trabajo.width = escW;
+    trabajo.height = escH;
+    trabajo.channels = canales;
+    trabajo.duenio = buddy;
+    trabajo.pool = buddy ? nullptr : pool;
+    trabajo.transformada = true;
+    return true;
+}
+
+bool codificar(const std::vector<std::string>& entradas, TrabajoLote& trabajo, const OpcionesLote& opciones) {
+    const std::string& entrada = entradas[trabajo.indice];
+    std::string salida = aplicarPlantilla(opciones.plantilla, entrada, trabajo.indice);
+    bool ok = guardarImagen(salida.c_str(), trabajo.pixeles, trabajo.width, trabajo.height, trabajo.channels, opciones.salida);
+    if (ok && opciones.cache) {
+        std::string archivoFinal;
+        resolverFormatoSalida(salida, opciones.salida.formato, archivoFinal);
+        opciones.cache->almacenar(trabajo.clave, archivoFinal);
+    }
+    if (ok) {
+        // Una sola escritura por linea para que no se mezclen entre hilos
+        std::cout << ("[LOTE] " + entrada + " -> " + salida + " (" + std::to_string(trabajo.width) + "x" +
+                      std::to_string(trabajo.height) + ")\n");
+    } else {
+        std::cerr << "[LOTE] Error procesando " << entrada << "\n";
+    }
+    liberar(trabajo);
+    return ok;
+}
+
+void mostrarResumen(size_t total, int fallidas, std::chrono::high_resolution_clock::time_point inicio,
+                    const CacheResultados* cache, const PoolBuffers* pool) {
+    auto fin = std::chrono::high_resolution_clock::now();
+    double tiempo = std::chrono::duration<double, std::milli>(fin - inicio).count();
+    std::cout << "[LOTE] Imágenes: " << total << " | Fallidas: " << fallidas
+              << " | Tiempo total: " << tiempo << " ms";
+    if (total > 0) {
+        std::cout << " | Promedio: " << tiempo / total << " ms/imagen";
+    }
+    if (cache) {
+        std::cout << " | Desde caché: " << cache->numAciertos();
+    }
+    std::cout << "\n";
+    if (pool) {
+        std::cout << "[LOTE] Pool de buffers: " << pool->numAciertos() << " reutilizados | "
+                  << pool->numFallos() << " nuevos | " << pool->numRecortados() << " devueltos al sistema | pico guardado "
+                  << pool->picoMemoria() / 1024 << " KB\n";
+    }
+}
+
+std::unique_ptr<PoolBuffers> crearPool(const OpcionesLote& opciones) {
+    if (opciones.usarBuddy || opciones.limitePool == 0) return nullptr;
+    return std::unique_ptr<PoolBuffers>(
+        new PoolBuffers(opciones.limitePool, std::chrono::milliseconds(opciones.inactividadPoolMs)));
+}
+
+} // namespace
+
+std::vector<std::string> listarEntradasLote(const std::string& origen) {
+    std::vector<std::string> entradas;
+
+    if (esDirectorio(origen)) {
+        DIR* dir = opendir(origen.c_str());
+        if (!dir) return entradas;
+        std::string prefijo = origen.back() == '/' ? origen : origen + "/";
+        while (dirent* e = readdir(dir)) {
+            std::string nombre = e->d_name;
+            if (nombre[0] != '.' && tieneExtensionImagen(nombre)) {
+                entradas.push_back(prefijo + nombre);
+            }
+        }
+        closedir(dir);
+        std::sort(entradas.begin(), entradas.end());
+    } else if (origen.find_first_of("*?[") != std::string::npos) {
+        glob_t resultado;
+        if (glob(origen.c_str(), 0, nullptr, &resultado) == 0) {
+            for (size_t i = 0; i < resultado.gl_pathc; ++i) {
+                entradas.push_back(resultado.gl_pathv[i]);
+            }
+        }
+        globfree(&resultado);
+    } else {
+        std::ifstream manifiesto(origen);
+        std::string linea;
+        while (std::getline(manifiesto, linea)) {
+            while (!linea.empty() && std::isspace(static_cast<unsigned char>(linea.back()))) linea.pop_back();
+            if (!linea.empty() && linea[0] != '#') {
+                entradas.push_back(linea);
+            }
+        }
+    }
+
+    return entradas;
+}
+
+std::string aplicarPlantilla(const std::string& plantilla, const std::string& entrada, size_t indice) {
+    size_t barra = entrada.find_last_of('/');
+    std::string dir = barra == std::string::npos ? "." : entrada.substr(0, barra);
+    std::string base = barra == std::string::npos ? entrada : entrada.substr(barra + 1);
+    size_t punto = base.find_last_of('.');
+    std::string nombre = punto == std::string::npos ? base : base.substr(0, punto);
+    std::string ext = punto == std::string::npos ? "" : base.substr(punto + 1);
+
+    std::string salida = plantilla;
+    reemplazarTodo(salida, "{nombre}", nombre);
+    reemplazarTodo(salida, "{ext}", ext);
+    reemplazarTodo(salida, "{dir}", dir);
+    reemplazarTodo(salida, "{indice}", std::to_string(indice));
+    return salida;
+}
+
+int procesarLote(const std::vector<std::string>& entradas, const OpcionesLote& opciones) {
+    if (opciones.tuberia) {
+        return procesarLoteEnTuberia(entradas, opciones);
+    }
+
+    // Un solo Buddy System para todo el lote en lugar de uno por imagen
+    std::unique_ptr<BuddyTrabajador> buddy;
+    if (opciones.usarBuddy) {
+        buddy.reset(new BuddyTrabajador(opciones.memoriaBuddy));
+    }
+    std::unique_ptr<PoolBuffers> pool = crearPool(opciones);
+
+    int fallidas = 0;
+    auto inicioLote = std::chrono::high_resolution_clock::now();
+
+    for (size_t i = 0; i < entradas.size(); ++i) {
+        TrabajoLote trabajo;
+        trabajo.indice = i;
+        if (recuperarDeCache(entradas, trabajo, opciones)) continue;
+        bool ok = decodificar(entradas, trabajo) &&
+                  transformar(trabajo, buddy.get(), pool.get(), opciones) &&
+                  codificar(entradas, trabajo, opciones);
+        if (!ok) {
+            liberar(trabajo);
+            ++fallidas;
+        }
+    }
+
+    mostrarResumen(entradas.size(), fallidas, inicioLote, opciones.cache, pool.get());
+    return fallidas;
+}
+
+int procesarLoteEnTuberia(const std::vector<std::string>& entradas, const OpcionesLote& opciones) {
+    int hilosDec = std::max(1, opciones.hilosDecodificacion);
+    int hilosTra = std::max(1, opciones.hilosTransformacion);
+    int hilosCod = std::max(1, opciones.hilosCodificacion);
+
+    // BuddySystem no es seguro entre hilos: cada transformador tiene el suyo
+    std::vector<std::unique_ptr<BuddyTrabajador>> buddies;
+    if (opciones.usarBuddy) {
+        for (int t = 0; t < hilosTra; ++t) {
+            buddies.emplace_back(new BuddyTrabajador(opciones.memoriaBuddy));
+        }
+    }
+    // El pool es compartido: los codificadores devuelven los buffers que asignan los transformadores
+    std::unique_ptr<PoolBuffers> pool = crearPool(opciones);
+
+    ColaAcotada<TrabajoLote> decodificadas(opciones.capacidadCola);
+    ColaAcotada<TrabajoLote> transformadas(opciones.capacidadCola);
+    std::atomic<size_t> siguiente(0);
+    std::atomic<int> fallidas(0);
+    std::atomic<int> decodificadoresActivos(hilosDec);
+    std::atomic<int> transformadoresActivos(hilosTra);
+    auto inicioLote = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> hilos;
+    for (int t = 0; t < hilosDec; ++t) {
+        hilos.emplace_back([&]() {
+            if (trazaHabilitada) nombrarHiloTraza("decodificacion");
+            for (size_t i = siguiente++; i < entradas.size(); i = siguiente++) {
+                TrabajoLote trabajo;
+                trabajo.indice = i;
+                if (recuperarDeCache(entradas, trabajo, opciones)) continue;
+                if (decodificar(entradas, trabajo)) {
+                    decodificadas.encolar(std::move(trabajo));
+                } else {
+                    ++fallidas;
+                }
+            }
+            if (--decodificadoresActivos == 0) decodificadas.cerrar();
+        });
+    }
+    for (int t = 0; t < hilosTra; ++t) {
+        BuddyTrabajador* buddy = buddies.empty() ? nullptr : buddies[t].get();
+        hilos.emplace_back([&, buddy]() {
+            if (trazaHabilitada) nombrarHiloTraza("transformacion");
+            TrabajoLote trabajo;
+            while (decodificadas.desencolar(trabajo)) {
+                if (transformar(trabajo, buddy, pool.get(), opciones)) {
+                    transformadas.encolar(std::move(trabajo));
+                } else {
+                    liberar(trabajo);
+                    ++fallidas;
+                }
+            }
+            if (--transformadoresActivos == 0) transformadas.cerrar();
+        });
+    }
+    for (int t = 0; t < hilosCod; ++t) {
+        hilos.emplace_back([&]() {
+            if (trazaHabilitada) nombrarHiloTraza("codificacion");
+            TrabajoLote trabajo;
+            while (transformadas.desencolar(trabajo)) {
+                if (!codificar(entradas, trabajo, opciones)) ++fallidas;
+            }
+        });
+    }
+    for (auto& h : hilos) {
+        h.join();
+    }
+
+    mostrarResumen(entradas.size(), fallidas, inicioLote, opciones.cache, pool.get());
+    return fallidas;
+}
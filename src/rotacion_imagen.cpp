@@ -1,62 +1,74 @@
-#include "procesamiento_imagen.h"
-#include <cmath>
-#include <cstring>
-#include <iostream>
-
-void calcularNuevoTamano(int width, int height, float angle, int& newWidth, int& newHeight) {
-    float rad = angle * M_PI / 180.0f;
-    float cosA = std::abs(std::cos(rad));
-    float sinA = std::abs(std::sin(rad));
-    newWidth = std::ceil(width * cosA + height * sinA);
-    newHeight = std::ceil(width * sinA + height * cosA);
-}
-
-unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, BuddySystem& buddy, int& newWidth, int& newHeight) {
-    // Verificar parámetros de entrada
-    if (!image || width <= 0 || height <= 0 || channels <= 0 || channels > 4) {
-        std::cerr << "Error: Parámetros inválidos para rotación\n";
-        return nullptr;
-    }
-
-    calcularNuevoTamano(width, height, angle, newWidth, newHeight);
-    float rad = angle * M_PI / 180.0f;
-    
-    // Calcular tamaño necesario
-    size_t requiredSize = newWidth * newHeight * channels;
-    if (requiredSize == 0) {
-        std::cerr << "Error: Tamaño calculado inválido para rotación\n";
-        return nullptr;
-    }
-
-    // Asignar memoria con BuddySystem
-    unsigned char* rotatedImage = static_cast<unsigned char*>(buddy.allocate(requiredSize));
-    if (!rotatedImage) {
-        std::cerr << "Error: No se pudo asignar memoria para imagen rotada (" 
-                  << requiredSize << " bytes requeridos)\n";
-        return nullptr;
-    }
-
-    // Inicializar memoria
-    std::memset(rotatedImage, 0, requiredSize);
-
-    int cx = width / 2;
-    int cy = height / 2;
-    int ncx = newWidth / 2;
-    int ncy = newHeight / 2;
-
-    for (int y = 0; y < newHeight; y++) {
-        for (int x = 0; x < newWidth; x++) {
-            float xt = (x - ncx) * std::cos(rad) + (y - ncy) * std::sin(rad) + cx;
-            float yt = -(x - ncx) * std::sin(rad) + (y - ncy) * std::cos(rad) + cy;
-
-            if (xt >= 0 && xt < width && yt >= 0 && yt < height) {
-                for (int c = 0; c < channels; c++) {
-                    rotatedImage[(y * newWidth + x) * channels + c] =
-                        bilinearInterpolation(xt, yt, image, width, height, channels, c);
-                }
-            }
-        }
-    }
-
-    return rotatedImage;
-}
\ No newline at end of file
+#include "procesamiento_imagen.h"
+#include "motor_transformacion.h"
+#include "traza.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+void calcularNuevoTamano(int width, int height, float angle, int& newWidth, int& newHeight) {
+    double rad = angle * M_PI / 180.0;
+    double cosA = std::abs(std::cos(rad));
+    double sinA = std::abs(std::sin(rad));
+    // El margen evita que el error de redondeo de cos(90) agregue una columna entera
+    newWidth = static_cast<int>(std::ceil(width * cosA + height * sinA - 1e-6));
+    newHeight = static_cast<int>(std::ceil(width * sinA + height * cosA - 1e-6));
+}
+
+namespace {
+
+// Igual para 8 bits, 16 bits y float
+template <typename T>
+T* rotarMuestras(const T* image, int width, int height, int channels, float angle, AsignadorImagen& asignador,
+                 int& newWidth, int& newHeight, const FondoTransformacion& fondo, Interpolacion interpolacion) {
+    TRAZA_TRAMO("rotar", "kernel");
+    MatrizAfin directa = matrizRotacionImagen(width, height, angle, newWidth, newHeight);
+    return conInterpolacion(interpolacion, [&](auto politica) {
+        return transformarImagen<decltype(politica)>(image, width, height, channels, directa.inversa(),
+                                                     newWidth, newHeight, asignador, fondo);
+    });
+}
+
+} // namespace
+
+unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, AsignadorImagen& asignador, int& newWidth, int& newHeight,
+                           const FondoTransformacion& fondo, Interpolacion interpolacion) {
+    return rotarMuestras(const_cast<const unsigned char*>(image), width, height, channels, angle, asignador,
+                         newWidth, newHeight, fondo, interpolacion);
+}
+
+uint16_t* rotarImagen(const uint16_t* image, int width, int height, int channels, float angle, AsignadorImagen& asignador,
+                      int& newWidth, int& newHeight, const FondoTransformacion& fondo, Interpolacion interpolacion) {
+    return rotarMuestras(image, width, height, channels, angle, asignador, newWidth, newHeight, fondo, interpolacion);
+}
+
+float* rotarImagen(const float* image, int width, int height, int channels, float angle, AsignadorImagen& asignador,
+                   int& newWidth, int& newHeight, const FondoTransformacion& fondo, Interpolacion interpolacion) {
+    return rotarMuestras(image, width, height, channels, angle, asignador, newWidth, newHeight, fondo, interpolacion);
+}
+
+bool rotarImagenEn(const unsigned char* image, int width, int height, int channels, float angle,
+                   unsigned char* destino, int newWidth, int newHeight, size_t pasoDestino,
+                   const FondoTransformacion& fondo, Interpolacion interpolacion) {
+    TRAZA_TRAMO("rotar", "kernel");
+    int esperadoAncho = 0, esperadoAlto = 0;
+    MatrizAfin directa = matrizRotacionImagen(width, height, angle, esperadoAncho, esperadoAlto);
+    if (newWidth != esperadoAncho || newHeight != esperadoAlto) {
+        std::cerr << "Error: El destino de la rotación debe medir " << esperadoAncho << "x" << esperadoAlto
+                  << " (recibido " << newWidth << "x" << newHeight << ")\n";
+        return false;
+    }
+    return conInterpolacion(interpolacion, [&](auto politica) {
+        return transformarImagenEn<decltype(politica)>(image, width, height, channels, directa.inversa(),
+                                                       destino, newWidth, newHeight, pasoDestino, fondo);
+    });
+}
+
+unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, BuddySystem& buddy, int& newWidth, int& newHeight) {
+    AsignadorBuddy asignador(buddy);
+    return rotarImagen(image, width, height, channels, angle, asignador, newWidth, newHeight);
+}
+
+unsigned char* rotarImagen(unsigned char* image, int width, int height, int channels, float angle, int& newWidth, int& newHeight) {
+    AsignadorHeap asignador;
+    return rotarImagen(image, width, height, channels, angle, asignador, newWidth, newHeight);
+}
@@ -0,0 +1,192 @@
+#include "transformacion_afin.h"
+#include "motor_transformacion.h"
+#include "procesamiento_imagen.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <cstdio>
+
+bool interpolacionDesdeTexto(const char* texto, Interpolacion& interpolacion) {
+    if (std::strcmp(texto, "vecino") == 0) {
+        interpolacion = Interpolacion::Vecino;
+    } else if (std::strcmp(texto, "bilineal") == 0) {
+        interpolacion = Interpolacion::Bilineal;
+    } else if (std::strcmp(texto, "lineal") == 0) {
+        interpolacion = Interpolacion::BilinealLineal;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool fondoDesdeTexto(const char* texto, FondoTransformacion& fondo) {
+    if (std::strcmp(texto, "transparente") == 0) {
+        fondo.modo = ModoFondo::Transparente;
+        return true;
+    }
+    if (std::strcmp(texto, "extender") == 0) {
+        fondo.modo = ModoFondo::ExtenderBorde;
+        return true;
+    }
+    if (std::strcmp(texto, "repetir") == 0) {
+        fondo.modo = ModoFondo::Repetir;
+        return true;
+    }
+    if (std::strcmp(texto, "alfa") == 0) {
+        fondo.modo = ModoFondo::Alfa;
+        return true;
+    }
+    int r, g, b, a = 255;
+    int leidos = sscanf(texto, "%d,%d,%d,%d", &r, &g, &b, &a);
+    if (leidos < 3) return false;
+    for (int v : {r, g, b, a}) {
+        if (v < 0 || v > 255) return false;
+    }
+    fondo.modo = ModoFondo::Constante;
+    fondo.color[0] = static_cast<unsigned char>(r);
+    fondo.color[1] = static_cast<unsigned char>(g);
+    fondo.color[2] = static_cast<unsigned char>(b);
+    fondo.color[3] = static_cast<unsigned char>(a);
+    return true;
+}
+
+int canalesConFondo(int channels, const FondoTransformacion& fondo) {
+    return fondo.modo == ModoFondo::Alfa ? canalesConAlfa(channels) : channels;
+}
+
+void colorFondoPara(const FondoTransformacion& fondo, int channels, unsigned char* px) {
+    std::memset(px, 0, 4);
+    if (fondo.modo != ModoFondo::Constante) return;
+    const unsigned char* c = fondo.color;
+    if (channels <= 2) {
+        // Luminancia BT.601, la misma que usa la conversion a gris
+        px[0] = static_cast<unsigned char>((c[0] * 299 + c[1] * 587 + c[2] * 114 + 500) / 1000);
+        if (channels == 2) px[1] = c[3];
+    } else {
+        std::memcpy(px, c, channels);
+    }
+}
+
+MatrizAfin MatrizAfin::traslacion(double tx, double ty) {
+    MatrizAfin m;
+    m.c = tx;
+    m.f = ty;
+    return m;
+}
+
+MatrizAfin MatrizAfin::escala(double sx, double sy) {
+    MatrizAfin m;
+    m.a = sx;
+    m.e = sy;
+    return m;
+}
+
+MatrizAfin MatrizAfin::rotacion(double grados) {
+    double rad = grados * M_PI / 180.0;
+    MatrizAfin m;
+    m.a = std::cos(rad);  m.b = -std::sin(rad);
+    m.d = std::sin(rad);  m.e = std::cos(rad);
+    return m;
+}
+
+MatrizAfin MatrizAfin::componer(const MatrizAfin& p) const {
+    MatrizAfin r;
+    r.a = a * p.a + b * p.d;
+    r.b = a * p.b + b * p.e;
+    r.c = a * p.c + b * p.f + c;
+    r.d = d * p.a + e * p.d;
+    r.e = d * p.b + e * p.e;
+    r.f = d * p.c + e * p.f + f;
+    return r;
+}
+
+MatrizAfin MatrizAfin::inversa() const {
+    double det = a * e - b * d;
+    MatrizAfin r;
+    r.a = e / det;
+    r.b = -b / det;
+    r.d = -d / det;
+    r.e = a / det;
+    r.c = -(r.a * c + r.b * f);
+    r.f = -(r.d * c + r.e * f);
+    return r;
+}
+
+bool MatrizAfin::esIdentidad(double tolerancia) const {
+    return std::abs(a - 1) < tolerancia && std::abs(b) < tolerancia && std::abs(c) < tolerancia &&
+           std::abs(d) < tolerancia && std::abs(e - 1) < tolerancia && std::abs(f) < tolerancia;
+}
+
+MatrizAfin matrizRotacionImagen(int width, int height, float angle, int& newWidth, int& newHeight) {
+    calcularNuevoTamano(width, height, angle, newWidth, newHeight);
+    return MatrizAfin::traslacion(newWidth / 2.0, newHeight / 2.0)
+        .componer(MatrizAfin::rotacion(angle))
+        .componer(MatrizAfin::traslacion(-width / 2.0, -height / 2.0));
+}
+
+MatrizAfin matrizEscalaImagen(int width, int height, float scaleFactor, int& newWidth, int& newHeight) {
+    newWidth = static_cast<int>(std::round(width * scaleFactor));
+    newHeight = static_cast<int>(std::round(height * scaleFactor));
+    return MatrizAfin::escala(scaleFactor, scaleFactor);
+}
+
+Rectangulo Rectangulo::interseccion(const Rectangulo& otro) const {
+    Rectangulo r;
+    r.x = std::max(x, otro.x);
+    r.y = std::max(y, otro.y);
+    r.width = std::min(x + width, otro.x + otro.width) - r.x;
+    r.height = std::min(y + height, otro.y + otro.height) - r.y;
+    if (r.vacio()) {
+        r.width = r.height = 0;
+    }
+    return r;
+}
+
+Rectangulo proyectarRectangulo(const MatrizAfin& inversa, const Rectangulo& destino, int width, int height) {
+    if (destino.vacio()) return Rectangulo();
+
+    // La imagen de un rectangulo por una transformacion afin queda acotada por sus esquinas
+    double esquinasX[2] = {static_cast<double>(destino.x), static_cast<double>(destino.x + destino.width - 1)};
+    double esquinasY[2] = {static_cast<double>(destino.y), static_cast<double>(destino.y + destino.height - 1)};
+    double minX = 1e300, minY = 1e300, maxX = -1e300, maxY = -1e300;
+    for (double ex : esquinasX) {
+        for (double ey : esquinasY) {
+            double sx = inversa.a * ex + inversa.b * ey + inversa.c;
+            double sy = inversa.d * ex + inversa.e * ey + inversa.f;
+            minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+            minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+        }
+    }
+
+    // Margen de un pixel por redondeo y otro por el vecino bilineal
+    Rectangulo fuente;
+    fuente.x = static_cast<int>(std::floor(minX)) - 1;
+    fuente.y = static_cast<int>(std::floor(minY)) - 1;
+    fuente.width = static_cast<int>(std::ceil(maxX)) + 2 - fuente.x;
+    fuente.height = static_cast<int>(std::ceil(maxY)) + 2 - fuente.y;
+
+    Rectangulo completo;
+    completo.width = width;
+    completo.height = height;
+    return fuente.interseccion(completo);
+}
+
+void aplicarTransformacionAfin(const unsigned char* image, int width, int height, int channels,
+                               const MatrizAfin& inversa, unsigned char* destino, int newWidth, int newHeight,
+                               Interpolacion interpolacion, int bloqueAncho, int bloqueAlto) {
+    Rectangulo fuente, salida;
+    fuente.width = width;
+    fuente.height = height;
+    salida.width = newWidth;
+    salida.height = newHeight;
+    aplicarTransformacionAfin(image, fuente, channels, inversa, destino, salida, interpolacion, bloqueAncho, bloqueAlto);
+}
+
+void aplicarTransformacionAfin(const unsigned char* image, const Rectangulo& regionFuente, int channels,
+                               const MatrizAfin& inversa, unsigned char* destino, const Rectangulo& regionDestino,
+                               Interpolacion interpolacion, int bloqueAncho, int bloqueAlto) {
+    conInterpolacion(interpolacion, [&](auto politica) {
+        transformarRegion<decltype(politica)>(image, regionFuente, channels, inversa, destino, regionDestino,
+                                              bloqueAncho, bloqueAlto);
+    });
+}
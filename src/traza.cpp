@@ -0,0 +1,138 @@
+#include "traza.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic<bool> trazaHabilitada(false);
+
+namespace {
+
+struct EventoTraza {
+    const char* nombre;
+    const char* categoria;
+    uint64_t inicioNs;
+    uint64_t duracionNs;
+};
+
+const size_t EVENTOS_POR_BLOQUE = 1024;
+
+// Bloque de eventos de un hilo. El hilo duenio escribe la ranura y despues
+// publica la cantidad con release; el lector solo mira lo ya publicado.
+struct BloqueEventos {
+    EventoTraza eventos[EVENTOS_POR_BLOQUE];
+    std::atomic<size_t> usados{0};
+    std::atomic<BloqueEventos*> siguiente{nullptr};
+};
+
+// Buffer propio de un hilo. Sobrevive al hilo (lo guarda el registro) para
+// que los hilos de corta vida de la tuberia no pierdan sus eventos.
+struct BufferTraza {
+    int tid = 0;
+    std::string nombreHilo;   // Protegido por mutexRegistro
+    BloqueEventos primero;
+    BloqueEventos* actual = &primero;
+
+    ~BufferTraza() {
+        BloqueEventos* b = primero.siguiente.load();
+        while (b) {
+            BloqueEventos* sig = b->siguiente.load();
+            delete b;
+            b = sig;
+        }
+    }
+};
+
+std::mutex mutexRegistro;
+std::vector<std::unique_ptr<BufferTraza>> buffers;
+uint64_t origenNs = 0;
+
+BufferTraza* bufferDelHilo() {
+    thread_local BufferTraza* buffer = nullptr;
+    if (!buffer) {
+        // Solo la primera vez de cada hilo: registrar el buffer bajo el mutex
+        std::lock_guard<std::mutex> bloqueo(mutexRegistro);
+        buffers.emplace_back(new BufferTraza());
+        buffer = buffers.back().get();
+        buffer->tid = static_cast<int>(buffers.size());
+    }
+    return buffer;
+}
+
+void escribirTextoJSON(FILE* archivo, const char* texto) {
+    fputc('"', archivo);
+    for (const char* p = texto; *p; ++p) {
+        if (*p == '"' || *p == '\\') fputc('\\', archivo);
+        fputc(*p, archivo);
+    }
+    fputc('"', archivo);
+}
+
+} // namespace
+
+uint64_t relojTrazaNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void iniciarTraza() {
+    origenNs = relojTrazaNs();
+    nombrarHiloTraza("principal");
+    trazaHabilitada.store(true, std::memory_order_release);
+}
+
+void nombrarHiloTraza(const char* nombre) {
+    BufferTraza* buffer = bufferDelHilo();
+    std::lock_guard<std::mutex> bloqueo(mutexRegistro);
+    buffer->nombreHilo = nombre;
+}
+
+void registrarTramo(const char* nombre, const char* categoria, uint64_t inicioNs, uint64_t finNs) {
+    BufferTraza* buffer = bufferDelHilo();
+    size_t n = buffer->actual->usados.load(std::memory_order_relaxed);
+    if (n == EVENTOS_POR_BLOQUE) {
+        BloqueEventos* nuevo = new BloqueEventos();
+        buffer->actual->siguiente.store(nuevo, std::memory_order_release);
+        buffer->actual = nuevo;
+        n = 0;
+    }
+    buffer->actual->eventos[n] = {nombre, categoria, inicioNs, finNs - inicioNs};
+    buffer->actual->usados.store(n + 1, std::memory_order_release);
+}
+
+bool guardarTraza(const char* filename) {
+    trazaHabilitada.store(false, std::memory_order_release);
+    FILE* archivo = fopen(filename, "w");
+    if (!archivo) return false;
+
+    std::lock_guard<std::mutex> bloqueo(mutexRegistro);
+    fputs("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n", archivo);
+    bool primero = true;
+    for (const auto& buffer : buffers) {
+        if (!buffer->nombreHilo.empty()) {
+            fprintf(archivo, "%s{\"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"name\": \"thread_name\", \"args\": {\"name\": ",
+                    primero ? "" : ",\n", buffer->tid);
+            escribirTextoJSON(archivo, buffer->nombreHilo.c_str());
+            fputs("}}", archivo);
+            primero = false;
+        }
+        for (const BloqueEventos* b = &buffer->primero; b; b = b->siguiente.load(std::memory_order_acquire)) {
+            size_t usados = b->usados.load(std::memory_order_acquire);
+            for (size_t i = 0; i < usados; ++i) {
+                const EventoTraza& e = b->eventos[i];
+                fprintf(archivo, "%s{\"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, \"name\": ",
+                        primero ? "" : ",\n", buffer->tid,
+                        (e.inicioNs - origenNs) / 1000.0, e.duracionNs / 1000.0);
+                escribirTextoJSON(archivo, e.nombre);
+                fputs(", \"cat\": ", archivo);
+                escribirTextoJSON(archivo, e.categoria);
+                fputc('}', archivo);
+                primero = false;
+            }
+        }
+    }
+    fputs("\n]}\n", archivo);
+    return fclose(archivo) == 0;
+}
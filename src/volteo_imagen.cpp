@@ -0,0 +1,87 @@
+#include "procesamiento_imagen.h"
+#include "planificador.h"
+#include "traza.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+bool validarEnSitio(const unsigned char* image, int width, int height, int channels, size_t& paso) {
+    if (!image || width <= 0 || height <= 0 || channels <= 0 || channels > 4) {
+        std::cerr << "Error: Parámetros inválidos para la transformación en sitio\n";
+        return false;
+    }
+    size_t bytesFila = static_cast<size_t>(width) * channels;
+    if (paso == 0) paso = bytesFila;
+    if (paso < bytesFila) {
+        std::cerr << "Error: El paso entre filas (" << paso << ") es menor que una fila (" << bytesFila << " bytes)\n";
+        return false;
+    }
+    return true;
+}
+
+// Invierte el orden de los pixeles de una fila
+void invertirFila(unsigned char* fila, int width, int channels) {
+    unsigned char* izq = fila;
+    unsigned char* der = fila + static_cast<size_t>(width - 1) * channels;
+    unsigned char px[4];
+    while (izq < der) {
+        std::memcpy(px, izq, channels);
+        std::memcpy(izq, der, channels);
+        std::memcpy(der, px, channels);
+        izq += channels;
+        der -= channels;
+    }
+}
+
+// Intercambia dos filas; con 'invertir' cada una queda ademas al reves
+void intercambiarFilas(unsigned char* a, unsigned char* b, int width, int channels, bool invertir) {
+    std::swap_ranges(a, a + static_cast<size_t>(width) * channels, b);
+    if (invertir) {
+        invertirFila(a, width, channels);
+        invertirFila(b, width, channels);
+    }
+}
+
+// Recorre las parejas de filas (y, height-1-y); la fila central de una altura
+// impar solo se invierte si hace falta
+void recorrerParejas(unsigned char* image, int width, int height, int channels, size_t paso, bool invertir) {
+    int parejas = height / 2;
+    Planificador::global().paraCada(0, parejas, granoFilas(paso * 2), [&](int inicio, int fin) {
+        for (int y = inicio; y < fin; ++y) {
+            intercambiarFilas(image + static_cast<size_t>(y) * paso,
+                              image + static_cast<size_t>(height - 1 - y) * paso, width, channels, invertir);
+        }
+    });
+    if (invertir && (height % 2) != 0) {
+        invertirFila(image + static_cast<size_t>(parejas) * paso, width, channels);
+    }
+}
+
+} // namespace
+
+bool voltearHorizontal(unsigned char* image, int width, int height, int channels, size_t paso) {
+    TRAZA_TRAMO("voltear_horizontal", "kernel");
+    if (!validarEnSitio(image, width, height, channels, paso)) return false;
+    Planificador::global().paraCada(0, height, granoFilas(paso), [&](int inicio, int fin) {
+        for (int y = inicio; y < fin; ++y) {
+            invertirFila(image + static_cast<size_t>(y) * paso, width, channels);
+        }
+    });
+    return true;
+}
+
+bool voltearVertical(unsigned char* image, int width, int height, int channels, size_t paso) {
+    TRAZA_TRAMO("voltear_vertical", "kernel");
+    if (!validarEnSitio(image, width, height, channels, paso)) return false;
+    recorrerParejas(image, width, height, channels, paso, false);
+    return true;
+}
+
+bool rotar180(unsigned char* image, int width, int height, int channels, size_t paso) {
+    TRAZA_TRAMO("rotar180", "kernel");
+    if (!validarEnSitio(image, width, height, channels, paso)) return false;
+    recorrerParejas(image, width, height, channels, paso, true);
+    return true;
+}